@@ -52,6 +52,8 @@ AdvancedCodeAnalysis analyze(evmc_revision rev, bytes_view code) noexcept
     const auto max_args_storage_size = code.size() + 1;
     analysis.push_values.reserve(max_args_storage_size);
 
+    analysis.jumpdest_bitmap.resize((code.size() + 63) / 64);
+
     // Create first block.
     analysis.instrs.emplace_back(opx_beginblock_fn);
     auto block = BlockAnalysis{0};
@@ -74,8 +76,10 @@ AdvancedCodeAnalysis analyze(evmc_revision rev, bytes_view code) noexcept
             block = BlockAnalysis{analysis.instrs.size()};
 
             // The JUMPDEST is always the first instruction in the block.
-            analysis.jumpdest_offsets.emplace_back(static_cast<int32_t>(code_pos - code_begin - 1));
+            const auto offset = static_cast<size_t>(code_pos - code_begin - 1);
+            analysis.jumpdest_offsets.emplace_back(static_cast<int32_t>(offset));
             analysis.jumpdest_targets.emplace_back(static_cast<int32_t>(analysis.instrs.size()));
+            analysis.jumpdest_bitmap[offset / 64].bits |= uint64_t{1} << (offset % 64);
         }
 
         analysis.instrs.emplace_back(opcode_info.fn);
@@ -222,6 +226,14 @@ AdvancedCodeAnalysis analyze(evmc_revision rev, bytes_view code) noexcept
     // Make sure the push_values has not been reallocated. Otherwise, iterators are invalid.
     assert(analysis.push_values.size() <= max_args_storage_size);
 
+    // Count the JUMPDESTs before each word of the bitmap.
+    uint32_t rank = 0;
+    for (auto& word : analysis.jumpdest_bitmap)
+    {
+        word.rank = rank;
+        rank += static_cast<uint32_t>(std::popcount(word.bits));
+    }
+
     return analysis;
 }
 
@@ -10,6 +10,7 @@
 #include <evmc/utils.h>
 #include <intx/intx.hpp>
 #include <array>
+#include <bit>
 #include <cstdint>
 #include <vector>
 
@@ -143,16 +144,33 @@ struct AdvancedCodeAnalysis
     /// matching the elements from jumdest_offsets.
     /// This is value to which the next instruction pointer must be set in JUMP/JUMPI.
     std::vector<int32_t> jumpdest_targets;
+
+    /// The word of the jumpdest bitmap of 64 code offsets.
+    struct JumpdestWord
+    {
+        uint64_t bits = 0;  ///< The bits of the offsets of JUMPDESTs.
+        uint32_t rank = 0;  ///< The number of JUMPDESTs before the first offset of the word.
+    };
+
+    /// The bitmap of the offsets of JUMPDESTs in the original code with the ranks.
+    /// It resolves the jump destination in constant time instead of searching
+    /// the jumpdest_offsets, using 16 bytes per 64 bytes of code.
+    std::vector<JumpdestWord> jumpdest_bitmap;
 };
 
 inline int find_jumpdest(const AdvancedCodeAnalysis& analysis, int offset) noexcept
 {
-    const auto begin = std::begin(analysis.jumpdest_offsets);
-    const auto end = std::end(analysis.jumpdest_offsets);
-    const auto it = std::lower_bound(begin, end, offset);
-    return (it != end && *it == offset) ?
-               analysis.jumpdest_targets[static_cast<size_t>(it - begin)] :
-               -1;
+    // The negative offset is converted to a value out of the bitmap range.
+    const auto index = static_cast<size_t>(offset);
+    if (index / 64 >= analysis.jumpdest_bitmap.size())
+        return -1;
+    const auto& word = analysis.jumpdest_bitmap[index / 64];
+    const auto mask = uint64_t{1} << (index % 64);
+    if ((word.bits & mask) == 0)
+        return -1;
+    // The rank of the JUMPDEST is the number of JUMPDESTs before it.
+    const auto rank = word.rank + static_cast<uint32_t>(std::popcount(word.bits & (mask - 1)));
+    return analysis.jumpdest_targets[rank];
 }
 
 EVMC_EXPORT AdvancedCodeAnalysis analyze(evmc_revision rev, bytes_view code) noexcept;
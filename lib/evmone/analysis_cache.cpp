@@ -0,0 +1,244 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "analysis_cache.hpp"
+#include <iterator>
+#include <string_view>
+
+namespace evmone::baseline
+{
+namespace
+{
+size_t hash_code(bytes_view code, bool eof_enabled, const AnalysisOptions& options) noexcept
+{
+    // The std::hash for strings processes the input word by word, this is much cheaper
+    // than the analysis itself.
+    const std::string_view s{reinterpret_cast<const char*>(code.data()), code.size()};
+    const auto flags = size_t{eof_enabled} | (size_t{options.superinstructions} << 1) |
+                       (size_t{options.block_checks} << 2) | (size_t{options.jit} << 3) |
+                       (static_cast<size_t>(options.rev) << 4);
+    return std::hash<std::string_view>{}(s) ^ flags;
+}
+
+/// Returns the approximated memory size of the analysis: the copies of the code,
+/// the jumpdest map, the block requirements and the native code.
+size_t analysis_size(
+    size_t code_size, const CodeAnalysis& analysis, const AnalysisOptions& options) noexcept
+{
+    return code_size * (analysis.has_superinstructions() ? 2 : 1) + code_size / 8 +
+           (options.block_checks || options.jit ? code_size / 2 : 0) +
+           (analysis.jit_code() ? analysis.jit_code().size() + code_size * 4 : 0);
+}
+
+/// Checks if the analysis can be kept in the analysis cache file.
+bool is_persistent(bool eof_code, const AnalysisOptions& options) noexcept
+{
+    return !eof_code && !options.block_checks && !options.jit;
+}
+}  // namespace
+
+struct AnalysisCache::Entry
+{
+    /// The analysis cache file the analysis code buffer is mapped from.
+    /// Null if the analysis owns the code.
+    const std::shared_ptr<const AnalysisCacheFile> file;
+
+    /// The copy of the EOF container referenced by the EOF analysis. Empty for legacy code
+    /// because the legacy analysis owns the (padded) copy of the code.
+    const bytes container;
+
+    const CodeAnalysis analysis;
+
+    const bool eof_enabled;
+
+    const AnalysisOptions options;
+
+    const size_t hash;
+
+    /// The approximated memory size of the entry. The mapped code buffer is not counted.
+    const size_t size;
+
+    /// Should the analysis be written to the analysis cache file? False for the analyses
+    /// mapped from the file.
+    const bool unsaved;
+
+    /// Has the entry been used since the last eviction pass?
+    std::atomic<bool> referenced = false;
+
+    Entry(bytes_view code, bool eof, const AnalysisOptions& opts, size_t code_hash,
+        std::shared_ptr<const AnalysisCacheFile> cache_file, const uint8_t* mapped_buffer)
+      : file{std::move(cache_file)},
+        container{eof && is_eof_container(code) ? code : bytes_view{}},
+        analysis{mapped_buffer != nullptr ?
+                     CodeAnalysis{mapped_buffer, code.size(), opts.superinstructions} :
+                     analyze(container.empty() ? code : bytes_view{container}, eof, opts)},
+        eof_enabled{eof},
+        options{opts},
+        hash{code_hash},
+        size{sizeof(Entry) + (file != nullptr ? 0 : analysis_size(code.size(), analysis, opts))},
+        unsaved{file == nullptr && is_persistent(analysis.eof_header().version != 0, opts)}
+    {}
+
+    [[nodiscard]] Key key() const noexcept
+    {
+        return {analysis.raw_code(), eof_enabled, options, hash};
+    }
+};
+
+std::shared_ptr<const CodeAnalysis> AnalysisCache::get(
+    bytes_view code, bool eof_enabled, const AnalysisOptions& options)
+{
+    if (auto analysis = find(code, eof_enabled, options))
+        return analysis;
+    return insert(make_entry(code, eof_enabled, options));
+}
+
+std::shared_ptr<const CodeAnalysis> AnalysisCache::find(
+    bytes_view code, bool eof_enabled, const AnalysisOptions& options) const noexcept
+{
+    const Key key{code, eof_enabled, options, hash_code(code, eof_enabled, options)};
+    const std::shared_ptr<Entry>* found = nullptr;
+    if (const auto it = m_index.find(key); it != m_index.end())
+        found = &*it->second;
+    else if (const auto fit = m_file_index.find(key); fit != m_file_index.end())
+        found = &fit->second;
+    else
+        return nullptr;
+
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    const auto& entry = *found;
+    // Avoid writing to the shared cache line of the frequently used entry.
+    if (!entry->referenced.load(std::memory_order_relaxed))
+        entry->referenced.store(true, std::memory_order_relaxed);
+    return {entry, &entry->analysis};
+}
+
+AnalysisCache::NewEntry AnalysisCache::make_entry(
+    bytes_view code, bool eof_enabled, const AnalysisOptions& options) const
+{
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    const uint8_t* mapped_buffer = nullptr;
+    if (m_file != nullptr && !m_file->entries().empty() &&
+        is_persistent(eof_enabled && is_eof_container(code), options))
+    {
+        mapped_buffer =
+            m_file->find(code, AnalysisCacheFile::hash(code), options.superinstructions);
+        if (mapped_buffer != nullptr)
+            m_file_hits.fetch_add(1, std::memory_order_relaxed);
+    }
+    return std::make_shared<Entry>(code, eof_enabled, options,
+        hash_code(code, eof_enabled, options), mapped_buffer != nullptr ? m_file : nullptr,
+        mapped_buffer);
+}
+
+std::shared_ptr<const CodeAnalysis> AnalysisCache::insert(NewEntry entry)
+{
+    // Keep the persistent entries regardless of the size limit.
+    if (m_file != nullptr && (entry->file != nullptr || entry->unsaved))
+    {
+        const auto [it, inserted] = m_file_index.try_emplace(entry->key(), entry);
+        if (inserted)
+        {
+            ++m_stats.num_file_entries;
+            m_file_outdated = m_file_outdated || entry->unsaved;
+        }
+        const auto& e = it->second;
+        return {e, &e->analysis};
+    }
+
+    // Skip entries which would not fit in the cache anyway.
+    if (entry->size > m_max_size)
+        return {entry, &entry->analysis};
+
+    const auto [it, inserted] = m_index.try_emplace(entry->key());
+    if (!inserted)
+    {
+        const auto& existing = *it->second;
+        existing->referenced.store(true, std::memory_order_relaxed);
+        return {existing, &existing->analysis};
+    }
+
+    m_stats.num_bytes += entry->size;
+    ++m_stats.num_entries;
+    m_file_outdated = m_file_outdated || entry->unsaved;
+    m_lru.push_front(entry);
+    it->second = m_lru.begin();
+    evict();
+    return {entry, &entry->analysis};
+}
+
+void AnalysisCache::evict() noexcept
+{
+    while (m_stats.num_bytes > m_max_size)
+    {
+        const auto& entry = m_lru.back();
+        if (entry->referenced.exchange(false, std::memory_order_relaxed))
+        {
+            // Give the used entry the second chance.
+            m_lru.splice(m_lru.begin(), m_lru, std::prev(m_lru.end()));
+            continue;
+        }
+        m_index.erase(entry->key());
+        m_stats.num_bytes -= entry->size;
+        --m_stats.num_entries;
+        ++m_stats.evictions;
+        m_lru.pop_back();
+    }
+}
+
+void AnalysisCache::set_max_size(size_t max_size) noexcept
+{
+    m_max_size = max_size;
+    evict();
+}
+
+bool AnalysisCache::open_file(std::string path)
+{
+    auto file = AnalysisCacheFile::open(std::move(path));
+    if (file == nullptr)
+        return false;
+    m_file = std::move(file);
+    return true;
+}
+
+bool AnalysisCache::save_file()
+{
+    if (m_file == nullptr)
+        return false;
+    if (!m_file_outdated)
+        return true;  // Do not rewrite the file with the same contents.
+
+    std::vector<AnalysisCacheFile::Record> records;
+    for (const auto& e : m_file->entries())
+        records.push_back({e.code_hash, m_file->buffer(e), e.code_size, e.superinstructions != 0});
+    const auto add_unsaved = [&records](const Entry& entry) {
+        if (!entry.unsaved)
+            return;
+        const auto& analysis = entry.analysis;
+        const auto code = analysis.raw_code();
+        records.push_back({AnalysisCacheFile::hash(code), code.data(), code.size(),
+            analysis.has_superinstructions()});
+    };
+    for (const auto& [_, entry] : m_file_index)
+        add_unsaved(*entry);
+    // The analyses cached before the file has been opened.
+    for (const auto& entry : m_lru)
+        add_unsaved(*entry);
+    if (!AnalysisCacheFile::write(m_file->path(), std::move(records)))
+        return false;
+    m_file_outdated = false;
+    return true;
+}
+
+void AnalysisCache::clear() noexcept
+{
+    m_index.clear();
+    m_lru.clear();
+    m_file_index.clear();
+    m_stats.num_bytes = 0;
+    m_stats.num_entries = 0;
+    m_stats.num_file_entries = 0;
+    m_file_outdated = false;
+}
+}  // namespace evmone::baseline
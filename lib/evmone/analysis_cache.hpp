@@ -0,0 +1,173 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "analysis_cache_file.hpp"
+#include "baseline.hpp"
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace evmone::baseline
+{
+/// The cache of the Baseline code analyses.
+///
+/// It keeps the results of baseline::analyze() keyed by the analyzed code bytes so that
+/// frequently executed contracts are analyzed only once. The cache is bounded by the total
+/// approximated memory size of the entries. When the limit is exceeded the entries not used
+/// since the previous eviction pass are evicted, from the least recently inserted
+/// (the "second chance" approximation of LRU). A lookup only marks the entry as used,
+/// so the lookups can run concurrently (see find()).
+///
+/// The analyses are handed out as shared references. An entry evicted during a nested call
+/// stays valid as long as the outer call frame executing it keeps the reference.
+///
+/// The cache can be backed by the persistent analysis cache file (see AnalysisCacheFile).
+/// The legacy code analyses missing in the cache are then first looked up in the file
+/// and used in place. The persistent analyses are kept in the separate index
+/// not bounded by the size limit: the ones mapped from the file take little memory
+/// and the new ones must be kept to be written to the file with save_file().
+/// This also works with the size limit 0, i.e. with only the file enabled.
+class EVMC_EXPORT AnalysisCache
+{
+public:
+    /// The cache statistics.
+    struct Stats
+    {
+        uint64_t hits = 0;            ///< Number of lookups served from the cache.
+        uint64_t misses = 0;          ///< Number of lookups not served from the cache.
+        uint64_t file_hits = 0;       ///< Number of misses served from the analysis cache file.
+        uint64_t evictions = 0;       ///< Number of entries evicted to respect the size limit.
+        size_t num_entries = 0;       ///< Number of entries in the size-limited cache.
+        size_t num_bytes = 0;         ///< Approximated memory size of these entries.
+        size_t num_file_entries = 0;  ///< Number of entries mapped from or to be saved to the file.
+    };
+
+private:
+    struct Entry;
+
+    /// The lookup key. The code references either the lookup argument
+    /// or the copy of the code owned by the cache entry.
+    struct Key
+    {
+        bytes_view code;
+        bool eof_enabled = false;
+        AnalysisOptions options;
+        size_t hash = 0;
+
+        bool operator==(const Key& other) const noexcept
+        {
+            return eof_enabled == other.eof_enabled && options == other.options &&
+                   code == other.code;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const noexcept { return key.hash; }
+    };
+
+    using LRUList = std::list<std::shared_ptr<Entry>>;
+
+    /// The entries ordered from the most recently inserted or given the second chance.
+    LRUList m_lru;
+
+    /// The index of the entries.
+    std::unordered_map<Key, LRUList::iterator, KeyHash> m_index;
+
+    /// The index of the persistent entries when the file is opened: the ones mapped from
+    /// the file and the ones to be saved to it. Not bounded by the size limit.
+    std::unordered_map<Key, std::shared_ptr<Entry>, KeyHash> m_file_index;
+
+    /// The size limit of the cache in bytes. The 0 disables the cache.
+    size_t m_max_size = 0;
+
+    /// The statistics except the lookup counters.
+    Stats m_stats;
+
+    /// The lookup counters, updated also by the concurrent lookups.
+    mutable std::atomic<uint64_t> m_hits = 0;
+    mutable std::atomic<uint64_t> m_misses = 0;
+    mutable std::atomic<uint64_t> m_file_hits = 0;
+
+    /// The persistent analysis cache file. May be null.
+    std::shared_ptr<const AnalysisCacheFile> m_file;
+
+    /// Have the analyses to be saved to the file been inserted since the last save?
+    bool m_file_outdated = false;
+
+    /// Evicts the entries not used since the previous pass until the cache fits in the size limit.
+    void evict() noexcept;
+
+public:
+    /// The analysis created by make_entry(), not inserted in the cache yet.
+    using NewEntry = std::shared_ptr<Entry>;
+
+    explicit AnalysisCache(size_t max_size = 0) noexcept : m_max_size{max_size} {}
+
+    /// Returns the analysis of the code, either from the cache or the freshly created one.
+    ///
+    /// @param code         The EVM code.
+    /// @param eof_enabled  Should the EOF code prefix be recognized as EOF code?
+    /// @param options      The options of the legacy code analysis (see analyze()).
+    /// @return             The shared reference to the analysis. It must be kept alive
+    ///                     for the duration of the execution.
+    std::shared_ptr<const CodeAnalysis> get(
+        bytes_view code, bool eof_enabled, const AnalysisOptions& options = {});
+
+    /// Looks up the analysis of the code in the cache. Returns null if not found.
+    /// It does not modify the cache so it is safe to call concurrently with other find()
+    /// and make_entry() calls.
+    [[nodiscard]] std::shared_ptr<const CodeAnalysis> find(
+        bytes_view code, bool eof_enabled, const AnalysisOptions& options = {}) const noexcept;
+
+    /// Creates the analysis of the code missing in the cache, to be inserted with insert().
+    /// It does not access the cache entries so it is safe to call concurrently with find().
+    [[nodiscard]] NewEntry make_entry(
+        bytes_view code, bool eof_enabled, const AnalysisOptions& options = {}) const;
+
+    /// Inserts the new entry unless the analysis of the same code is in the cache already
+    /// (e.g. inserted by another thread meanwhile). Returns the analysis from the cache.
+    std::shared_ptr<const CodeAnalysis> insert(NewEntry entry);
+
+    /// Returns true if the cache has non-zero size limit or is backed by the file.
+    [[nodiscard]] bool enabled() const noexcept { return m_max_size != 0 || m_file != nullptr; }
+
+    /// The size limit of the cache in bytes.
+    [[nodiscard]] size_t max_size() const noexcept { return m_max_size; }
+
+    /// Sets the new size limit of the cache in bytes. Entries exceeding it are evicted.
+    void set_max_size(size_t max_size) noexcept;
+
+    /// Removes all the entries, also the ones not saved to the file yet.
+    /// The statistics counters are preserved.
+    void clear() noexcept;
+
+    /// Opens the analysis cache file. The file is created by save_file() if it does not exist.
+    /// Returns false if the existing file cannot be used.
+    bool open_file(std::string path);
+
+    /// Writes the analyses from the file and the cached legacy code analyses
+    /// (except the ones with the block checks) to the file. The file is not rewritten
+    /// if no analysis missing in it has been made since the last save.
+    /// Returns false on failure or if no file is opened.
+    bool save_file();
+
+    /// The analysis cache file. May be null.
+    [[nodiscard]] const AnalysisCacheFile* file() const noexcept { return m_file.get(); }
+
+    /// Returns the cache statistics.
+    [[nodiscard]] Stats stats() const noexcept
+    {
+        auto stats = m_stats;
+        stats.hits = m_hits.load(std::memory_order_relaxed);
+        stats.misses = m_misses.load(std::memory_order_relaxed);
+        stats.file_hits = m_file_hits.load(std::memory_order_relaxed);
+        return stats;
+    }
+};
+}  // namespace evmone::baseline
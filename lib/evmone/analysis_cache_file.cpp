@@ -0,0 +1,229 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "analysis_cache_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_WIN32)
+#define EVMONE_ANALYSIS_CACHE_FILE_SUPPORTED 0
+#else
+#define EVMONE_ANALYSIS_CACHE_FILE_SUPPORTED 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace evmone::baseline
+{
+namespace
+{
+using Header = AnalysisCacheFile::Header;
+using IndexEntry = AnalysisCacheFile::IndexEntry;
+
+static_assert(sizeof(Header) == 32);
+static_assert(sizeof(IndexEntry) == 24);
+
+constexpr size_t ALIGNMENT = CodeAnalysis::BUFFER_ALIGNMENT;
+
+constexpr size_t align_up(size_t x) noexcept
+{
+    return (x + (ALIGNMENT - 1)) / ALIGNMENT * ALIGNMENT;
+}
+
+/// The offset of the first code buffer.
+constexpr size_t data_offset(size_t num_entries) noexcept
+{
+    return align_up(sizeof(Header) + num_entries * sizeof(IndexEntry));
+}
+
+/// Computes the FNV-1a hash of the 64-bit words of the data.
+/// The last word is padded with zeros if the size is not the multiple of the word size.
+uint64_t hash_words(const uint8_t* data, size_t size, uint64_t h = 0xcbf29ce484222325) noexcept
+{
+    constexpr auto word_size = sizeof(uint64_t);
+    for (size_t i = 0; i < size; i += word_size)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, &data[i], std::min(word_size, size - i));
+        h = (h ^ word) * 0x100000001b3;
+    }
+    return h;
+}
+
+/// Computes the checksum of the file contents after the header.
+uint64_t checksum(const uint8_t* data, size_t size) noexcept
+{
+    return hash_words(&data[sizeof(Header)], size - sizeof(Header));
+}
+
+/// Checks if the file contents have valid header, checksum and index.
+bool validate(const uint8_t* data, size_t size) noexcept
+{
+    if (size < sizeof(Header) || size % ALIGNMENT != 0)
+        return false;
+
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != AnalysisCacheFile::MAGIC || header.version != AnalysisCacheFile::VERSION ||
+        header.file_size != size || data_offset(header.num_entries) > size)
+        return false;
+
+    if (header.checksum != checksum(data, size))
+        return false;
+
+    const auto* const index = reinterpret_cast<const IndexEntry*>(&data[sizeof(Header)]);
+    for (size_t i = 0; i < header.num_entries; ++i)
+    {
+        const auto& e = index[i];
+        if (e.offset % ALIGNMENT != 0 || e.offset > size ||
+            CodeAnalysis::buffer_size(e.code_size, e.superinstructions != 0) > size - e.offset)
+            return false;
+    }
+    return true;
+}
+
+/// The order of the index entries and the records.
+template <typename T>
+bool less(const T& a, const T& b) noexcept
+{
+    return a.code_hash < b.code_hash ||
+           (a.code_hash == b.code_hash && a.superinstructions < b.superinstructions);
+}
+}  // namespace
+
+std::shared_ptr<const AnalysisCacheFile> AnalysisCacheFile::open(std::string path)
+{
+    std::shared_ptr<AnalysisCacheFile> file{new AnalysisCacheFile{std::move(path)}};
+#if EVMONE_ANALYSIS_CACHE_FILE_SUPPORTED
+    const auto fd = ::open(file->m_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return errno == ENOENT ? file : nullptr;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    const auto size = static_cast<size_t>(st.st_size);
+    if (size != 0)
+    {
+        auto* const mem = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mem == MAP_FAILED)
+        {
+            close(fd);
+            return nullptr;
+        }
+        file->m_data = static_cast<const uint8_t*>(mem);
+        file->m_size = size;
+    }
+    close(fd);  // The mapping stays valid.
+
+    if (!validate(file->m_data, file->m_size))
+        return file;  // The contents are ignored and will be replaced by write().
+
+    Header header;
+    std::memcpy(&header, file->m_data, sizeof(header));
+    file->m_index = {
+        reinterpret_cast<const IndexEntry*>(&file->m_data[sizeof(Header)]), header.num_entries};
+    return file;
+#else
+    return nullptr;
+#endif
+}
+
+AnalysisCacheFile::~AnalysisCacheFile()
+{
+#if EVMONE_ANALYSIS_CACHE_FILE_SUPPORTED
+    if (m_data != nullptr)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
+
+bool AnalysisCacheFile::write(const std::string& path, std::vector<Record> records)
+{
+    std::ranges::sort(records, less<Record>);
+    const auto [first, last] = std::ranges::unique(records, [](const Record& a, const Record& b) {
+        return !less(a, b) && !less(b, a);
+    });
+    records.erase(first, last);
+
+    auto size = data_offset(records.size());
+    std::vector<IndexEntry> index;
+    index.reserve(records.size());
+    for (const auto& r : records)
+    {
+        index.push_back({r.code_hash, size, static_cast<uint32_t>(r.code_size),
+            uint32_t{r.superinstructions}});
+        size = align_up(size + CodeAnalysis::buffer_size(r.code_size, r.superinstructions));
+    }
+
+    std::vector<uint8_t> data(size);
+    std::memcpy(&data[sizeof(Header)], index.data(), index.size() * sizeof(IndexEntry));
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        std::memcpy(&data[index[i].offset], records[i].buffer,
+            CodeAnalysis::buffer_size(records[i].code_size, records[i].superinstructions));
+    }
+    const Header header{
+        .num_entries = static_cast<uint32_t>(records.size()),
+        .file_size = size,
+        .checksum = checksum(data.data(), size),
+    };
+    std::memcpy(data.data(), &header, sizeof(header));
+
+#if EVMONE_ANALYSIS_CACHE_FILE_SUPPORTED
+    // Write to the unique temporary file and rename it so that other processes never see
+    // the partially written file and the existing mappings of the old file stay valid.
+    auto tmp_path = path + ".XXXXXX";
+    const auto fd = mkstemp(tmp_path.data());
+    if (fd < 0)
+        return false;
+    auto* const f = fdopen(fd, "wb");
+    if (f == nullptr)
+    {
+        close(fd);
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    const auto written = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+    if (std::fclose(f) != 0 || !written || std::rename(tmp_path.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t AnalysisCacheFile::hash(bytes_view code) noexcept
+{
+    const auto h = hash_words(code.data(), code.size(), 0xcbf29ce484222325 ^ code.size());
+    return h ^ (h >> 32);  // Fold the better mixed high bits into the low bits.
+}
+
+const uint8_t* AnalysisCacheFile::find(
+    bytes_view code, uint64_t code_hash, bool superinstructions) const noexcept
+{
+    const IndexEntry key{code_hash, 0, 0, uint32_t{superinstructions}};
+    const auto it = std::ranges::lower_bound(m_index, key, less<IndexEntry>);
+    if (it == m_index.end() || it->code_hash != code_hash ||
+        it->superinstructions != key.superinstructions || it->code_size != code.size())
+        return nullptr;
+
+    // Compare the code to not depend on the hash uniqueness only.
+    const auto* const buffer = this->buffer(*it);
+    if (!std::equal(code.begin(), code.end(), buffer))
+        return nullptr;
+    return buffer;
+}
+}  // namespace evmone::baseline
@@ -0,0 +1,150 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "baseline.hpp"
+#include "baseline_superinstructions.hpp"
+#include <evmc/evmc.hpp>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace evmone::baseline
+{
+/// Computes the analysis cache file format version: the FNV-1a hash of the sizes
+/// of the file records, the layout of the CodeAnalysis code buffer and the encoding
+/// of the superinstructions. The files written by an incompatible build are ignored then.
+consteval uint32_t analysis_cache_file_version(size_t header_size, size_t index_entry_size) noexcept
+{
+    uint64_t h = 0xcbf29ce484222325;
+    const auto add = [&h](uint64_t value) noexcept { h = (h ^ value) * 0x100000001b3; };
+
+    add(header_size);
+    add(index_entry_size);
+    add(CodeAnalysis::BUFFER_ALIGNMENT);
+    add(CodeAnalysis::JUMPDEST_WORD_BITS);
+    for (const size_t code_size : {1, 31, 32, 33, 63, 64, 65, 1000})
+    {
+        add(CodeAnalysis::buffer_size(code_size, false));
+        add(CodeAnalysis::buffer_size(code_size, true));
+    }
+
+#define ON_OPCODE(OPCODE)
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED(OPCODE, NAME)                   \
+    add(OPCODE);                                        \
+    for (const auto c : std::string_view{#NAME})        \
+        add(static_cast<uint8_t>(c));
+    MAP_OPCODES
+#undef ON_OPCODE
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED ON_OPCODE_FUSED_DEFAULT
+    add(OP_UNDEFINED_REPLACEMENT);
+    add(FUSED_PUSH_MAX_SIZE);
+    add(FUSED_DUP_SWAP_MAX);
+
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+/// The persistent analysis cache file.
+///
+/// The file keeps the legacy code analyses in the format of the CodeAnalysis code buffer
+/// (the padded code, the jumpdest bitset and optionally the code with superinstructions)
+/// so that the analyses are used in place from the memory-mapped file without copying.
+/// The file layout:
+/// - the Header,
+/// - the index of IndexEntry sorted by the code hash and the superinstructions flag,
+/// - the code buffers aligned to CodeAnalysis::BUFFER_ALIGNMENT.
+///
+/// The block requirements and the native code are not persisted. The analyses of Advanced
+/// are not persisted either because they contain the addresses of the instruction
+/// implementations valid only in the process which created them.
+class EVMC_EXPORT AnalysisCacheFile
+{
+public:
+    /// The file magic number: "evmoneAC" in little-endian.
+    static constexpr uint64_t MAGIC = 0x4341656e6f6d7665;
+
+    /// The file header.
+    struct Header
+    {
+        uint64_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint32_t num_entries = 0;  ///< The number of index entries.
+        uint64_t file_size = 0;    ///< The total file size.
+        uint64_t checksum = 0;     ///< The checksum of the file contents after the header.
+    };
+
+    /// The index entry of the code analysis.
+    struct IndexEntry
+    {
+        uint64_t code_hash = 0;          ///< The hash of the code (see hash()).
+        uint64_t offset = 0;             ///< The offset of the code buffer in the file.
+        uint32_t code_size = 0;          ///< The code size.
+        uint32_t superinstructions = 0;  ///< Does the code buffer contain superinstructions?
+    };
+
+    /// The file format version (see analysis_cache_file_version()).
+    static constexpr uint32_t VERSION =
+        analysis_cache_file_version(sizeof(Header), sizeof(IndexEntry));
+
+    /// The code analysis to be written to the file.
+    struct Record
+    {
+        uint64_t code_hash = 0;
+        const uint8_t* buffer = nullptr;  ///< The code buffer (see CodeAnalysis::buffer_size()).
+        size_t code_size = 0;
+        bool superinstructions = false;
+    };
+
+private:
+    std::string m_path;
+
+    /// The memory-mapped file contents. Null if the file is missing or invalid.
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+
+    std::span<const IndexEntry> m_index;
+
+    explicit AnalysisCacheFile(std::string path) noexcept : m_path{std::move(path)} {}
+
+public:
+    AnalysisCacheFile(const AnalysisCacheFile&) = delete;
+    AnalysisCacheFile& operator=(const AnalysisCacheFile&) = delete;
+    ~AnalysisCacheFile();
+
+    /// Opens and memory-maps the analysis cache file.
+    ///
+    /// The missing file and the file of a different version or invalid checksum are treated
+    /// as empty. Returns null if the existing file cannot be mapped.
+    static std::shared_ptr<const AnalysisCacheFile> open(std::string path);
+
+    /// Writes the analyses to the file. The file is replaced atomically and the concurrent
+    /// writers use distinct temporary files. The duplicated records are written once.
+    /// Returns false on failure.
+    static bool write(const std::string& path, std::vector<Record> records);
+
+    /// Computes the hash of the code the entries are keyed by.
+    /// The lookups compare the code so the cheap non-cryptographic hash is used.
+    static uint64_t hash(bytes_view code) noexcept;
+
+    [[nodiscard]] const std::string& path() const noexcept { return m_path; }
+
+    /// The index entries.
+    [[nodiscard]] std::span<const IndexEntry> entries() const noexcept { return m_index; }
+
+    /// Returns the code buffer of the index entry.
+    [[nodiscard]] const uint8_t* buffer(const IndexEntry& entry) const noexcept
+    {
+        return &m_data[entry.offset];
+    }
+
+    /// Finds the code buffer of the code analysis. Returns null if not found.
+    [[nodiscard]] const uint8_t* find(
+        bytes_view code, uint64_t code_hash, bool superinstructions) const noexcept;
+};
+}  // namespace evmone::baseline
@@ -3,10 +3,16 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include "baseline_jit.hpp"
 #include "eof.hpp"
+#include "instructions_opcodes.hpp"
 #include <evmc/evmc.h>
 #include <evmc/utils.h>
+#include <bit>
+#include <cstdint>
 #include <memory>
+#include <new>
+#include <string_view>
 #include <vector>
 
 namespace evmone
@@ -17,34 +23,233 @@ class VM;
 
 namespace baseline
 {
+/// The options of the legacy code analysis.
+struct AnalysisOptions
+{
+    /// Replace the common instruction sequences with superinstructions in the executable code.
+    bool superinstructions = false;
+
+    /// Compute the basic block requirements for the block checks execution mode.
+    /// The superinstructions are not used together with the block checks.
+    bool block_checks = false;
+
+    /// Compile the legacy code to the native code (see JitCode). This implies the block checks.
+    bool jit = false;
+
+    /// The EVM revision the block gas costs are computed for. Relevant only for the block checks.
+    evmc_revision rev = EVMC_FRONTIER;
+
+    bool operator==(const AnalysisOptions&) const noexcept = default;
+};
+
+/// The requirements of the basic block of the legacy code.
+///
+/// The block starts at the code beginning, at a JUMPDEST or after the instruction which either
+/// may continue at a different location (JUMPI) or depends on the exact gas left
+/// (GAS, SSTORE and the CALL and CREATE families). The block ends before the next block start
+/// or at a terminating instruction, JUMP or an instruction undefined in the revision.
+struct BlockInfo
+{
+    /// The total base gas cost of all instructions in the block.
+    uint32_t gas_cost = 0;
+
+    /// The stack height required to execute the block.
+    int16_t stack_req = 0;
+
+    /// The max stack height growth relative to the stack height at block start.
+    int16_t stack_max_growth = 0;
+};
+
+/// The pre-decoded EOF code section: the code location and the type of the section.
+///
+/// The entries are used by CALLF, RETF and JUMPF instead of decoding the EOF header
+/// on every call.
+struct EOFCodeSection
+{
+    /// The beginning of the code section in the container.
+    const uint8_t* code = nullptr;
+
+    uint8_t inputs = 0;   ///< The number of the section inputs.
+    uint8_t outputs = 0;  ///< The number of the section outputs or 0x80 if non-returning.
+
+    /// The max stack height growth above the section inputs.
+    uint16_t max_stack_increase = 0;
+};
+
+/// Checks if the instruction ends the basic block so that the next instruction starts a new one.
+/// These are JUMPI and the instructions using the exact gas left.
+constexpr bool splits_block(uint8_t op) noexcept
+{
+    switch (op)
+    {
+    case OP_JUMPI:
+    case OP_GAS:
+    case OP_SSTORE:
+    case OP_CREATE:
+    case OP_CALL:
+    case OP_CALLCODE:
+    case OP_DELEGATECALL:
+    case OP_CREATE2:
+    case OP_STATICCALL:
+        return true;
+    default:
+        return false;
+    }
+}
+
 class CodeAnalysis
 {
 public:
-    using JumpdestMap = std::vector<bool>;
+    /// The word type of the jumpdest bitset.
+    using JumpdestWord = uint64_t;
+
+    /// The number of bits in the jumpdest bitset word.
+    static constexpr size_t JUMPDEST_WORD_BITS = sizeof(JumpdestWord) * 8;
+
+    /// The size of the legacy code padding.
+    ///
+    /// We need at most 33 bytes of code padding: 32 for possible missing all data bytes of PUSH32
+    /// at the very end of the code; and one more byte for STOP to guarantee there is a terminating
+    /// instruction at the code end.
+    static constexpr size_t CODE_PADDING = 32 + 1;
+
+    /// The alignment of the code buffer: the typical CPU cache line size.
+    static constexpr size_t BUFFER_ALIGNMENT = 64;
+
+    /// The deleter of the aligned code buffer.
+    struct BufferDeleter
+    {
+        void operator()(uint8_t* p) const noexcept
+        {
+            ::operator delete[](p, std::align_val_t{BUFFER_ALIGNMENT});
+        }
+    };
+
+    /// The code buffer type.
+    using Buffer = std::unique_ptr<uint8_t[], BufferDeleter>;
 
 private:
     bytes_view m_raw_code;         ///< Unmodified full code.
     bytes_view m_executable_code;  ///< Executable code section.
-    JumpdestMap m_jumpdest_map;    ///< Map of valid jump destinations.
-    EOF1Header m_eof_header;       ///< The EOF header.
 
-    /// Padded code for faster legacy code execution.
+    /// Bitset of valid jump destinations. Located in the code buffer after the padded code.
+    const JumpdestWord* m_jumpdest_bitset = nullptr;
+
+    /// Number of bits in the jumpdest bitset. This is the legacy code size or 0 for EOF.
+    size_t m_jumpdest_bitset_size = 0;
+
+    /// Is the executable code the copy of the legacy code with superinstructions?
+    bool m_superinstructions = false;
+
+    /// The bitset word of the block start positions with the number of block starts
+    /// in the preceding words.
+    struct BlockStartsWord
+    {
+        uint64_t bits = 0;
+        uint32_t rank = 0;
+    };
+
+    /// The bitset of the block start positions (including the code end position).
+    /// Empty if the block requirements are not computed.
+    std::vector<BlockStartsWord> m_block_starts;
+
+    /// The block requirements in the order of the block start positions.
+    std::vector<BlockInfo> m_blocks;
+
+    /// The revision the block requirements are computed for.
+    evmc_revision m_blocks_rev = EVMC_FRONTIER;
+
+    /// The native code compiled from the legacy code with the block checks. May be empty.
+    JitCode m_jit_code;
+
+    EOF1Header m_eof_header;  ///< The EOF header.
+
+    /// The pre-decoded EOF code sections in the order of the header. Empty for legacy code.
+    std::vector<EOFCodeSection> m_eof_code_sections;
+
+    /// The single allocation for the legacy code: the padded code followed by the jumpdest bitset
+    /// and optionally the padded code with superinstructions.
     /// If not nullptr the executable_code must point to it.
-    std::unique_ptr<uint8_t[]> m_padded_code;
+    Buffer m_buffer;
 
 public:
+    /// Returns the offset of the jumpdest bitset in the legacy code buffer.
+    static constexpr size_t jumpdest_bitset_offset(size_t code_size) noexcept
+    {
+        // Place the bitset after the padded code, aligned to the bitset word size.
+        constexpr auto word_size = sizeof(JumpdestWord);
+        return (code_size + CODE_PADDING + (word_size - 1)) / word_size * word_size;
+    }
+
+    /// Returns the number of words of the jumpdest bitset for the legacy code.
+    static constexpr size_t jumpdest_bitset_num_words(size_t code_size) noexcept
+    {
+        return (code_size + (JUMPDEST_WORD_BITS - 1)) / JUMPDEST_WORD_BITS;
+    }
+
+    /// Returns the offset of the padded code with superinstructions in the legacy code buffer.
+    static constexpr size_t fused_code_offset(size_t code_size) noexcept
+    {
+        return jumpdest_bitset_offset(code_size) +
+               jumpdest_bitset_num_words(code_size) * sizeof(JumpdestWord);
+    }
+
+    /// Returns the size of the code buffer for the legacy code of the given size.
+    static constexpr size_t buffer_size(size_t code_size, bool superinstructions) noexcept
+    {
+        return fused_code_offset(code_size) + (superinstructions ? code_size + CODE_PADDING : 0);
+    }
+
+    /// Allocates the code buffer for the legacy code of the given size.
+    /// The buffer contents is not initialized.
+    static Buffer allocate_buffer(size_t code_size, bool superinstructions = false)
+    {
+        return Buffer{static_cast<uint8_t*>(::operator new[](
+            buffer_size(code_size, superinstructions), std::align_val_t{BUFFER_ALIGNMENT}))};
+    }
+
     /// Constructor for legacy code.
-    CodeAnalysis(std::unique_ptr<uint8_t[]> padded_code, size_t code_size, JumpdestMap map)
-      : m_raw_code{padded_code.get(), code_size},
-        m_executable_code{padded_code.get(), code_size},
-        m_jumpdest_map{std::move(map)},
-        m_padded_code{std::move(padded_code)}
+    ///
+    /// @param buffer     The code buffer allocated with allocate_buffer() containing
+    ///                   the padded code and the jumpdest bitset.
+    /// @param code_size  The size of the code (without padding).
+    /// @param superinstructions  Does the buffer contain the padded code with superinstructions?
+    ///                           If so, it becomes the executable code.
+    CodeAnalysis(Buffer buffer, size_t code_size, bool superinstructions = false) noexcept
+      : CodeAnalysis{static_cast<const uint8_t*>(buffer.get()), code_size, superinstructions}
+    {
+        m_buffer = std::move(buffer);
+    }
+
+    /// Constructor for legacy code referencing the code buffer owned elsewhere,
+    /// e.g. memory-mapped from the analysis cache file. The buffer must outlive the analysis
+    /// and be aligned to BUFFER_ALIGNMENT.
+    CodeAnalysis(const uint8_t* buffer, size_t code_size, bool superinstructions) noexcept
+      : m_raw_code{buffer, code_size},
+        m_executable_code{
+            superinstructions ? &buffer[fused_code_offset(code_size)] : buffer, code_size},
+        m_jumpdest_bitset{
+            reinterpret_cast<const JumpdestWord*>(&buffer[jumpdest_bitset_offset(code_size)])},
+        m_jumpdest_bitset_size{code_size},
+        m_superinstructions{superinstructions}
     {}
 
     /// Constructor for EOF.
     CodeAnalysis(bytes_view container, bytes_view executable_code, EOF1Header header)
       : m_raw_code{container}, m_executable_code(executable_code), m_eof_header{std::move(header)}
-    {}
+    {
+        m_eof_code_sections.reserve(m_eof_header.code_sizes.size());
+        for (size_t i = 0; i < m_eof_header.code_sizes.size(); ++i)
+        {
+            const auto type = m_eof_header.get_type(container, i);
+            m_eof_code_sections.push_back({
+                .code = &container[m_eof_header.code_offsets[i]],
+                .inputs = type.inputs,
+                .outputs = type.outputs,
+                .max_stack_increase = static_cast<uint16_t>(type.max_stack_height - type.inputs),
+            });
+        }
+    }
 
     /// The raw code as stored in accounts or passes as initcode. For EOF this is full container.
     [[nodiscard]] bytes_view raw_code() const noexcept { return m_raw_code; }
@@ -52,18 +257,55 @@ public:
     /// The pre-processed executable code. This is where interpreter should start execution.
     [[nodiscard]] bytes_view executable_code() const noexcept { return m_executable_code; }
 
+    /// Does the executable code contain superinstructions?
+    /// Such code must be executed with the superinstructions dispatch.
+    [[nodiscard]] bool has_superinstructions() const noexcept { return m_superinstructions; }
+
+    /// Has the analysis computed the block requirements for the given revision?
+    /// Such code can be executed with the block checks dispatch.
+    [[nodiscard]] bool has_block_checks(evmc_revision rev) const noexcept
+    {
+        return !m_blocks.empty() && m_blocks_rev == rev;
+    }
+
+    /// Returns the requirements of the block starting at the given position.
+    /// The position must be the block start.
+    [[nodiscard]] const BlockInfo& block_at(size_t position) const noexcept
+    {
+        const auto& word = m_block_starts[position / JUMPDEST_WORD_BITS];
+        const auto mask = (uint64_t{1} << (position % JUMPDEST_WORD_BITS)) - 1;
+        return m_blocks[word.rank + static_cast<size_t>(std::popcount(word.bits & mask))];
+    }
+
+    /// Computes the block requirements of the legacy code for the given revision.
+    void analyze_blocks(evmc_revision rev);
+
+    /// The native code of the legacy code. Empty if not compiled.
+    [[nodiscard]] const JitCode& jit_code() const noexcept { return m_jit_code; }
+
+    /// Compiles the legacy code with the computed block requirements to the native code.
+    /// The native code remains empty if the compilation is not supported.
+    void compile_jit() noexcept;
+
     /// Reference to the EOF header.
     [[nodiscard]] const EOF1Header& eof_header() const noexcept { return m_eof_header; }
 
+    /// Returns the pre-decoded EOF code section. The index must be valid.
+    [[nodiscard]] const EOFCodeSection& eof_code_section(size_t index) const noexcept
+    {
+        return m_eof_code_sections[index];
+    }
+
     /// Reference to the EOF data section. May be empty.
     [[nodiscard]] bytes_view eof_data() const noexcept { return m_eof_header.get_data(m_raw_code); }
 
     /// Check if given position is valid jump destination. Use only for legacy code.
     [[nodiscard]] bool check_jumpdest(uint64_t position) const noexcept
     {
-        if (position >= m_jumpdest_map.size())
+        if (position >= m_jumpdest_bitset_size)
             return false;
-        return m_jumpdest_map[static_cast<size_t>(position)];
+        const auto word = m_jumpdest_bitset[position / JUMPDEST_WORD_BITS];
+        return ((word >> (position % JUMPDEST_WORD_BITS)) & 1) != 0;
     }
 };
 
@@ -74,15 +316,35 @@ public:
 ///
 /// @param code         The reference to the EVM code to be analyzed.
 /// @param eof_enabled  Should the EOF code prefix be recognized as EOF code?
-EVMC_EXPORT CodeAnalysis analyze(bytes_view code, bool eof_enabled);
+/// @param options      The options of the legacy code analysis.
+EVMC_EXPORT CodeAnalysis analyze(
+    bytes_view code, bool eof_enabled, const AnalysisOptions& options = {});
+
+/// The implementation of the legacy code jumpdest analysis.
+/// It fills the bitset of jumpdest_bitset_num_words(code.size()) words.
+using JumpdestAnalysisFn = void (*)(bytes_view code, CodeAnalysis::JumpdestWord* bitset) noexcept;
+
+/// Returns the jumpdest analysis implementation by name: "scalar", "sse2", "avx2", "neon"
+/// or "best" for the one selected for the current CPU. Returns null if the implementation
+/// is not available in this build or on this CPU. For testing and benchmarking.
+EVMC_EXPORT JumpdestAnalysisFn get_jumpdest_analysis_fn(std::string_view name) noexcept;
+
+/// The support of the ahead-of-time compiled code provided by the VM.
+struct AotSupport;
+
+/// The ahead-of-time compiled contract code. Executes the code from the beginning.
+/// Returns the gas left and stores the status code in the state like the interpreter.
+using AotFn = int64_t (*)(ExecutionState& state, int64_t gas, const AotSupport& support) noexcept;
 
 /// Executes in Baseline interpreter using EVMC-compatible parameters.
 evmc_result execute(evmc_vm* vm, const evmc_host_interface* host, evmc_host_context* ctx,
     evmc_revision rev, const evmc_message* msg, const uint8_t* code, size_t code_size) noexcept;
 
 /// Executes in Baseline interpreter with the pre-processed code.
+/// If the ahead-of-time compiled code of the contract is provided, it is executed instead.
 EVMC_EXPORT evmc_result execute(VM&, const evmc_host_interface& host, evmc_host_context* ctx,
-    evmc_revision rev, const evmc_message& msg, const CodeAnalysis& analysis) noexcept;
+    evmc_revision rev, const evmc_message& msg, const CodeAnalysis& analysis,
+    AotFn aot_fn = nullptr) noexcept;
 
 }  // namespace baseline
 }  // namespace evmone
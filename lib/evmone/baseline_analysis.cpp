@@ -3,10 +3,21 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "baseline.hpp"
+#include "baseline_instruction_table.hpp"
+#include "baseline_superinstructions.hpp"
 #include "eof.hpp"
 #include "instructions.hpp"
+#include <bit>
+#include <cassert>
+#include <cstring>
 #include <memory>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace evmone::baseline
 {
 static_assert(std::is_move_constructible_v<CodeAnalysis>);
@@ -16,44 +27,346 @@ static_assert(!std::is_copy_assignable_v<CodeAnalysis>);
 
 namespace
 {
-CodeAnalysis::JumpdestMap analyze_jumpdests(bytes_view code)
+using JumpdestWord = CodeAnalysis::JumpdestWord;
+
+void analyze_jumpdests_scalar(bytes_view code, JumpdestWord* bitset) noexcept
 {
     // To find if op is any PUSH opcode (OP_PUSH1 <= op <= OP_PUSH32)
     // it can be noticed that OP_PUSH32 is INT8_MAX (0x7f) therefore
     // static_cast<int8_t>(op) <= OP_PUSH32 is always true and can be skipped.
     static_assert(OP_PUSH32 == std::numeric_limits<int8_t>::max());
 
-    CodeAnalysis::JumpdestMap map(code.size());  // Allocate and init bitmap with zeros.
+    constexpr auto word_bits = CodeAnalysis::JUMPDEST_WORD_BITS;
+    std::fill_n(bitset, CodeAnalysis::jumpdest_bitset_num_words(code.size()), JumpdestWord{0});
     for (size_t i = 0; i < code.size(); ++i)
     {
         const auto op = code[i];
         if (static_cast<int8_t>(op) >= OP_PUSH1)  // If any PUSH opcode (see explanation above).
             i += op - size_t{OP_PUSH1 - 1};       // Skip PUSH data.
         else if (INTX_UNLIKELY(op == OP_JUMPDEST))
-            map[i] = true;
+            bitset[i / word_bits] |= JumpdestWord{1} << (i % word_bits);
     }
+}
+
+#if defined(__x86_64__) || defined(__aarch64__)
+
+/// The size of the code block processed by the vectorized jumpdest analysis.
+/// It matches the size of the bitset word so every block produces a single word.
+constexpr size_t BLOCK_SIZE = CodeAnalysis::JUMPDEST_WORD_BITS;
+static_assert(BLOCK_SIZE == 64);
+
+/// The bitmasks of the JUMPDEST and PUSH opcodes in a code block.
+/// The masks are computed for all bytes, ignoring the instruction boundaries.
+struct BlockMasks
+{
+    uint64_t jumpdests;
+    uint64_t pushes;
+};
+
+/// Resolves the instruction boundaries of a code block and returns its jumpdest bitset word.
+///
+/// The walk jumps from one PUSH instruction to the next one using bit scans so the cost depends
+/// on the number of PUSH instructions in the block, not on the block size.
+///
+/// @param block       The code block.
+/// @param masks       The opcode masks of the block.
+/// @param [in,out] skip  The number of leading bytes of the block being the data of a PUSH
+///                       instruction from the previous block. On return, the same value for
+///                       the next block.
+[[gnu::always_inline]] inline JumpdestWord analyze_block(
+    const uint8_t* block, BlockMasks masks, size_t& skip) noexcept
+{
+    constexpr auto all = ~uint64_t{0};
+    JumpdestWord word = 0;
+    auto pos = skip;  // The position of the next instruction. Always less than BLOCK_SIZE here.
+    while (true)
+    {
+        const auto next_pushes = masks.pushes & (all << pos);
+        if (next_pushes == 0)
+        {
+            // Only single-byte instructions till the end of the block.
+            skip = 0;
+            return word | (masks.jumpdests & (all << pos));
+        }
+
+        const auto push_pos = static_cast<size_t>(std::countr_zero(next_pushes));
+        word |= masks.jumpdests & (all << pos) & ~(all << push_pos);
+        pos = push_pos + 1 + (block[push_pos] - size_t{OP_PUSH1 - 1});
+        if (pos >= BLOCK_SIZE)
+        {
+            skip = pos - BLOCK_SIZE;
+            return word;
+        }
+    }
+}
+
+/// The vectorized jumpdest analysis template.
+/// The LoadMasksFn computes the opcode masks of a code block using SIMD instructions.
+template <BlockMasks LoadMasksFn(const uint8_t*) noexcept>
+[[gnu::always_inline]] inline void analyze_jumpdests_blocks(
+    bytes_view code, JumpdestWord* bitset) noexcept
+{
+    const auto num_full_blocks = code.size() / BLOCK_SIZE;
+    size_t skip = 0;
+    for (size_t i = 0; i < num_full_blocks; ++i)
+    {
+        const auto block = &code[i * BLOCK_SIZE];
+        bitset[i] = analyze_block(block, LoadMasksFn(block), skip);
+    }
+
+    // The last partial block is analyzed from a copy extended with zeros (STOP)
+    // to not read past the code.
+    if (const auto tail_size = code.size() % BLOCK_SIZE; tail_size != 0)
+    {
+        uint8_t block[BLOCK_SIZE]{};
+        std::copy_n(&code[num_full_blocks * BLOCK_SIZE], tail_size, block);
+        bitset[num_full_blocks] = analyze_block(block, LoadMasksFn(block), skip);
+    }
+}
+#endif
+
+#if defined(__x86_64__)
+
+// PUSH opcodes are 0x60-0x7f, i.e. the only bytes greater than 0x5f in the signed comparison.
+static_assert(OP_PUSH32 == std::numeric_limits<int8_t>::max());
+
+/// Computes the opcode masks with SSE2 instructions. These are always available on x86-64.
+BlockMasks load_masks_sse2(const uint8_t* block) noexcept
+{
+    const auto jumpdest = _mm_set1_epi8(static_cast<char>(OP_JUMPDEST));
+    const auto push_min = _mm_set1_epi8(static_cast<char>(OP_PUSH1 - 1));
+    BlockMasks masks{};
+    for (size_t i = 0; i < BLOCK_SIZE / 16; ++i)
+    {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&block[i * 16]));
+        const auto j = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, jumpdest)));
+        const auto p = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(v, push_min)));
+        masks.jumpdests |= uint64_t{j} << (i * 16);
+        masks.pushes |= uint64_t{p} << (i * 16);
+    }
+    return masks;
+}
+
+__attribute__((target("avx2"))) BlockMasks load_masks_avx2(const uint8_t* block) noexcept
+{
+    const auto jumpdest = _mm256_set1_epi8(static_cast<char>(OP_JUMPDEST));
+    const auto push_min = _mm256_set1_epi8(static_cast<char>(OP_PUSH1 - 1));
+    BlockMasks masks{};
+    for (size_t i = 0; i < BLOCK_SIZE / 32; ++i)
+    {
+        const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&block[i * 32]));
+        const auto j =
+            static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, jumpdest)));
+        const auto p =
+            static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(v, push_min)));
+        masks.jumpdests |= uint64_t{j} << (i * 32);
+        masks.pushes |= uint64_t{p} << (i * 32);
+    }
+    return masks;
+}
+
+void analyze_jumpdests_sse2(bytes_view code, JumpdestWord* bitset) noexcept
+{
+    analyze_jumpdests_blocks<load_masks_sse2>(code, bitset);
+}
+
+__attribute__((target("avx2"))) void analyze_jumpdests_avx2(
+    bytes_view code, JumpdestWord* bitset) noexcept
+{
+    analyze_jumpdests_blocks<load_masks_avx2>(code, bitset);
+}
+
+#elif defined(__aarch64__)
+
+/// Computes the 16-bit mask from the NEON comparison result (all-ones or all-zeros bytes).
+inline uint64_t movemask_neon(uint8x16_t cmp) noexcept
+{
+    static constexpr uint8_t bit_weights[]{
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const auto bits = vandq_u8(cmp, vld1q_u8(bit_weights));
+    return uint64_t{vaddv_u8(vget_low_u8(bits))} | (uint64_t{vaddv_u8(vget_high_u8(bits))} << 8);
+}
+
+BlockMasks load_masks_neon(const uint8_t* block) noexcept
+{
+    const auto jumpdest = vdupq_n_u8(OP_JUMPDEST);
+    const auto push_min = vdupq_n_s8(OP_PUSH1 - 1);
+    BlockMasks masks{};
+    for (size_t i = 0; i < BLOCK_SIZE / 16; ++i)
+    {
+        const auto v = vld1q_u8(&block[i * 16]);
+        masks.jumpdests |= movemask_neon(vceqq_u8(v, jumpdest)) << (i * 16);
+        masks.pushes |= movemask_neon(vcgtq_s8(vreinterpretq_s8_u8(v), push_min)) << (i * 16);
+    }
+    return masks;
+}
+
+void analyze_jumpdests_neon(bytes_view code, JumpdestWord* bitset) noexcept
+{
+    analyze_jumpdests_blocks<load_masks_neon>(code, bitset);
+}
+#endif
 
-    return map;
+#if defined(__x86_64__)
+JumpdestAnalysisFn analyze_jumpdests_best = analyze_jumpdests_sse2;
+
+__attribute__((constructor)) void select_analyze_jumpdests_implementation() noexcept
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        analyze_jumpdests_best = analyze_jumpdests_avx2;
 }
+#elif defined(__aarch64__)
+// NEON (Advanced SIMD) is mandatory in AArch64.
+JumpdestAnalysisFn analyze_jumpdests_best = analyze_jumpdests_neon;
+#else
+JumpdestAnalysisFn analyze_jumpdests_best = analyze_jumpdests_scalar;
+#endif
 
-std::unique_ptr<uint8_t[]> pad_code(bytes_view code)
+void pad_code(bytes_view code, uint8_t* padded_code) noexcept
 {
-    // We need at most 33 bytes of code padding: 32 for possible missing all data bytes of PUSH32
-    // at the very end of the code; and one more byte for STOP to guarantee there is a terminating
-    // instruction at the code end.
-    constexpr auto padding = 32 + 1;
+    // Not std::ranges::copy(): libstdc++ 12 does not lower it to memmove for this pair of types
+    // and the byte loop was the most expensive part of the analysis of large code.
+    std::memcpy(padded_code, code.data(), code.size());
+    std::fill_n(&padded_code[code.size()], CodeAnalysis::CODE_PADDING, uint8_t{OP_STOP});
+}
 
-    auto padded_code = std::make_unique_for_overwrite<uint8_t[]>(code.size() + padding);
-    std::ranges::copy(code, padded_code.get());
-    std::fill_n(&padded_code[code.size()], padding, uint8_t{OP_STOP});
-    return padded_code;
+/// Returns the number of data bytes of the PUSH1-PUSH32 instructions or 0 for other opcodes.
+constexpr size_t push_data_size(uint8_t op) noexcept
+{
+    return (op >= OP_PUSH1 && op <= OP_PUSH32) ? size_t{op} - (OP_PUSH1 - 1) : 0;
 }
 
+/// Replaces the common instruction sequences with the superinstructions.
+///
+/// Only the first opcode of a sequence is replaced, the following instructions and the PUSH data
+/// stay in place so the code offsets are preserved. Jumps never land inside a sequence because
+/// it does not contain JUMPDEST. The undefined instructions colliding with the superinstruction
+/// opcodes are replaced with other undefined instruction.
+///
+/// @param code        The original code.
+/// @param fused_code  The padded copy of the code to be modified.
+void fuse_instructions(bytes_view code, uint8_t* fused_code) noexcept
+{
+    // Returns the opcode at the position or STOP for positions in the code padding.
+    const auto op_at = [code](size_t pos) noexcept {
+        return pos < code.size() ? code[pos] : uint8_t{OP_STOP};
+    };
 
-CodeAnalysis analyze_legacy(bytes_view code)
+    for (size_t i = 0; i < code.size();)
+    {
+        const auto op = code[i];
+        const auto push_size = push_data_size(op);
+        const auto next = i + 1 + push_size;
+        const auto next_op = op_at(next);
+        const auto is_fused_push = push_size != 0 && push_size <= FUSED_PUSH_MAX_SIZE;
+
+        uint8_t fused_op = 0;
+        auto end = next;  // The position after the replaced instructions.
+        if (is_fused_push && next_op == OP_JUMP)
+        {
+            fused_op = static_cast<uint8_t>(OP_PUSH1_JUMP + (push_size - 1));
+            end = next + 1;
+        }
+        else if (is_fused_push && next_op == OP_JUMPI)
+        {
+            fused_op = static_cast<uint8_t>(OP_PUSH1_JUMPI + (push_size - 1));
+            end = next + 1;
+        }
+        else if (op == OP_PUSH1 && next_op == OP_ADD)
+        {
+            fused_op = OP_PUSH1_ADD;
+            end = next + 1;
+        }
+        else if (op >= OP_DUP1 && op < OP_DUP1 + FUSED_DUP_SWAP_MAX && next_op >= OP_SWAP1 &&
+                 next_op < OP_SWAP1 + FUSED_DUP_SWAP_MAX)
+        {
+            fused_op = static_cast<uint8_t>(
+                OP_DUP1_SWAP1 + (op - OP_DUP1) * FUSED_DUP_SWAP_MAX + (next_op - OP_SWAP1));
+            end = next + 1;
+        }
+        else if (op == OP_ISZERO)
+        {
+            const auto jumpi_push_size = push_data_size(next_op);
+            const auto jumpi_pos = next + 1 + jumpi_push_size;
+            if (jumpi_push_size != 0 && jumpi_push_size <= FUSED_PUSH_MAX_SIZE &&
+                op_at(jumpi_pos) == OP_JUMPI)
+            {
+                fused_op = static_cast<uint8_t>(OP_ISZERO_PUSH1_JUMPI + (jumpi_push_size - 1));
+                end = jumpi_pos + 1;
+            }
+        }
+        else if (is_fused_opcode(op))
+        {
+            fused_op = OP_UNDEFINED_REPLACEMENT;
+        }
+
+        if (fused_op != 0)
+            fused_code[i] = fused_op;
+        i = end;
+    }
+}
+
+/// Clamps x to the max value of To type.
+template <typename To, typename T>
+constexpr To clamp(T x) noexcept
 {
-    // TODO: The padded code buffer and jumpdest bitmap can be created with single allocation.
-    return {pad_code(code), code.size(), analyze_jumpdests(code)};
+    constexpr auto max = std::numeric_limits<To>::max();
+    return x <= max ? static_cast<To>(x) : max;
+}
+
+/// The requirements of the basic block being analyzed.
+struct BlockAnalysis
+{
+    int64_t gas_cost = 0;
+
+    int stack_req = 0;
+    int stack_max_growth = 0;
+    int stack_change = 0;
+
+    /// Adds the instruction of the given base gas cost to the block.
+    void add(uint8_t op, int64_t cost) noexcept
+    {
+        const auto& traits = instr::traits[op];
+        stack_req = std::max(stack_req, traits.stack_height_required - stack_change);
+        stack_change += traits.stack_height_change;
+        stack_max_growth = std::max(stack_max_growth, stack_change);
+        gas_cost += cost;
+    }
+
+    /// Close the block by producing compressed information about the block.
+    [[nodiscard]] BlockInfo close() const noexcept
+    {
+        return {clamp<decltype(BlockInfo{}.gas_cost)>(gas_cost),
+            clamp<decltype(BlockInfo{}.stack_req)>(stack_req),
+            clamp<decltype(BlockInfo{}.stack_max_growth)>(stack_max_growth)};
+    }
+};
+
+CodeAnalysis analyze_legacy(bytes_view code, const AnalysisOptions& options)
+{
+    // The block checks use the original code.
+    const auto block_checks = options.block_checks || options.jit;
+    const auto superinstructions = options.superinstructions && !block_checks;
+
+    // The padded code, the jumpdest bitset and optionally the padded code with superinstructions
+    // are placed in a single allocation.
+    auto buffer = CodeAnalysis::allocate_buffer(code.size(), superinstructions);
+    pad_code(code, buffer.get());
+    analyze_jumpdests_best(code, reinterpret_cast<CodeAnalysis::JumpdestWord*>(
+                                     &buffer[CodeAnalysis::jumpdest_bitset_offset(code.size())]));
+    if (superinstructions)
+    {
+        const auto fused_code = &buffer[CodeAnalysis::fused_code_offset(code.size())];
+        pad_code(code, fused_code);
+        fuse_instructions(code, fused_code);
+    }
+    CodeAnalysis analysis{std::move(buffer), code.size(), superinstructions};
+    if (block_checks)
+        analysis.analyze_blocks(options.rev);
+    if (options.jit)
+        analysis.compile_jit();
+    return analysis;
 }
 
 CodeAnalysis analyze_eof1(bytes_view container)
@@ -72,10 +385,106 @@ CodeAnalysis analyze_eof1(bytes_view container)
 }
 }  // namespace
 
-CodeAnalysis analyze(bytes_view code, bool eof_enabled)
+void CodeAnalysis::analyze_blocks(evmc_revision rev)
+{
+    assert(m_eof_header.version == 0);
+    const auto code = m_raw_code;
+    const auto& cost_table = get_baseline_legacy_cost_table(rev);
+
+    // The code end position is also a block start when the last block is split before it.
+    m_block_starts.assign(code.size() / JUMPDEST_WORD_BITS + 1, {});
+    m_blocks.clear();
+    m_blocks_rev = rev;
+
+    BlockAnalysis block;
+    size_t block_start = 0;
+    bool in_block = true;  // False in the unreachable code after a terminating instruction.
+    const auto start_block = [&](size_t pos) noexcept {
+        m_block_starts[pos / JUMPDEST_WORD_BITS].bits |= uint64_t{1}
+                                                         << (pos % JUMPDEST_WORD_BITS);
+        block = {};
+        block_start = pos;
+        in_block = true;
+    };
+
+    start_block(0);
+    for (size_t i = 0; i < code.size();)
+    {
+        const auto op = code[i];
+        const auto next = i + 1 + push_data_size(op);
+
+        if (op == OP_JUMPDEST && !(in_block && block_start == i))
+        {
+            if (in_block)
+                m_blocks.emplace_back(block.close());
+            start_block(i);
+        }
+        else if (!in_block)
+        {
+            i = next;
+            continue;
+        }
+
+        const auto cost = cost_table[op];
+        if (cost < 0 || op == OP_JUMP || instr::traits[op].is_terminating)
+        {
+            // The undefined instruction fails anyway so it is not added to the block.
+            if (cost >= 0)
+                block.add(op, cost);
+            m_blocks.emplace_back(block.close());
+            in_block = false;
+        }
+        else
+        {
+            block.add(op, cost);
+            if (splits_block(op))
+            {
+                m_blocks.emplace_back(block.close());
+                start_block(next);
+            }
+        }
+        i = next;
+    }
+    if (in_block)
+        m_blocks.emplace_back(block.close());
+
+    uint32_t rank = 0;
+    for (auto& word : m_block_starts)
+    {
+        word.rank = rank;
+        rank += static_cast<uint32_t>(std::popcount(word.bits));
+    }
+    assert(rank == m_blocks.size());
+}
+
+void CodeAnalysis::compile_jit() noexcept
+{
+    assert(!m_blocks.empty());
+    m_jit_code = JitCode::compile(m_executable_code, get_jit_stubs());
+}
+
+CodeAnalysis analyze(bytes_view code, bool eof_enabled, const AnalysisOptions& options)
 {
     if (eof_enabled && is_eof_container(code))
         return analyze_eof1(code);
-    return analyze_legacy(code);
+    return analyze_legacy(code, options);
+}
+
+JumpdestAnalysisFn get_jumpdest_analysis_fn(std::string_view name) noexcept
+{
+    if (name == "best")
+        return analyze_jumpdests_best;
+    if (name == "scalar")
+        return analyze_jumpdests_scalar;
+#if defined(__x86_64__)
+    if (name == "sse2")
+        return analyze_jumpdests_sse2;
+    if (name == "avx2")
+        return __builtin_cpu_supports("avx2") ? analyze_jumpdests_avx2 : nullptr;
+#elif defined(__aarch64__)
+    if (name == "neon")
+        return analyze_jumpdests_neon;
+#endif
+    return nullptr;
 }
 }  // namespace evmone::baseline
@@ -0,0 +1,71 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "baseline_aot.hpp"
+#include <ethash/keccak.hpp>
+#include <cstring>
+
+#if defined(_WIN32)
+#define EVMONE_AOT_SUPPORTED 0
+#else
+#define EVMONE_AOT_SUPPORTED 1
+#include <dlfcn.h>
+#endif
+
+namespace evmone::baseline
+{
+AotRegistry::~AotRegistry()
+{
+#if EVMONE_AOT_SUPPORTED
+    for (auto* const library : m_libraries)
+        dlclose(library);
+#endif
+}
+
+bool AotRegistry::load([[maybe_unused]] const char* path) noexcept
+{
+#if EVMONE_AOT_SUPPORTED
+    auto* const library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (library == nullptr)
+        return false;
+
+    const auto contracts_fn =
+        reinterpret_cast<AotContractsFn>(dlsym(library, AOT_CONTRACTS_SYMBOL));
+    uint32_t abi_version = 0;
+    size_t num_contracts = 0;
+    const auto* const contracts =
+        contracts_fn != nullptr ? contracts_fn(&abi_version, &num_contracts) : nullptr;
+    if (contracts == nullptr || abi_version != AOT_ABI_VERSION)
+    {
+        dlclose(library);
+        return false;
+    }
+
+    m_libraries.push_back(library);
+    for (size_t i = 0; i < num_contracts; ++i)
+        add(contracts[i]);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AotRegistry::add(const AotContract& contract)
+{
+    m_contracts[contract.code_hash] = contract.fn;
+    m_code_sizes.insert(contract.code_size);
+}
+
+AotFn AotRegistry::find(bytes_view code) const noexcept
+{
+    if (!m_code_sizes.contains(code.size()))
+        return nullptr;
+
+    const auto hash = ethash::keccak256(code.data(), code.size());
+    evmc::bytes32 code_hash;
+    std::memcpy(code_hash.bytes, hash.bytes, sizeof(code_hash));
+    const auto it = m_contracts.find(code_hash);
+    return it != m_contracts.end() ? it->second : nullptr;
+}
+}  // namespace evmone::baseline
@@ -0,0 +1,66 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "baseline.hpp"
+#include <evmc/evmc.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace evmone::baseline
+{
+/// The version of the interface between the VM and the ahead-of-time compiled contracts.
+///
+/// The compiled code uses the internal evmone types (e.g. ExecutionState) so the shared objects
+/// must be built with the headers of the same evmone version as the VM loading them.
+constexpr uint32_t AOT_ABI_VERSION = 2;
+
+/// The ahead-of-time compiled contract.
+struct AotContract
+{
+    evmc::bytes32 code_hash;  ///< The Keccak-256 hash of the contract code.
+    size_t code_size = 0;     ///< The size of the contract code.
+    AotFn fn = nullptr;       ///< The compiled code.
+};
+
+/// The name of the function exported by the shared object with the compiled contracts.
+constexpr auto AOT_CONTRACTS_SYMBOL = "evmone_aot_contracts";
+
+/// The type of the function exported by the shared object with the compiled contracts.
+/// Returns the array of the compiled contracts and the ABI version the objects are built for.
+using AotContractsFn = const AotContract* (*)(uint32_t* abi_version, size_t* num_contracts);
+
+/// The registry of the ahead-of-time compiled contracts indexed by the code hash.
+class EVMC_EXPORT AotRegistry
+{
+    /// The handles of the loaded shared objects.
+    std::vector<void*> m_libraries;
+
+    /// The compiled contracts by the code hash.
+    std::unordered_map<evmc::bytes32, AotFn> m_contracts;
+
+    /// The sizes of the compiled contracts' code. Allows skipping the code hashing
+    /// for most of the contracts not in the registry.
+    std::unordered_set<size_t> m_code_sizes;
+
+public:
+    AotRegistry() noexcept = default;
+    AotRegistry(const AotRegistry&) = delete;
+    AotRegistry& operator=(const AotRegistry&) = delete;
+    ~AotRegistry();
+
+    /// Loads the compiled contracts from the shared object produced from the evmone-aotc output.
+    /// Returns false if the shared object cannot be loaded or is built for a different ABI.
+    bool load(const char* path) noexcept;
+
+    /// Adds the compiled contract.
+    void add(const AotContract& contract);
+
+    [[nodiscard]] bool empty() const noexcept { return m_contracts.empty(); }
+
+    /// Finds the compiled code of the contract code. Returns null if not found.
+    [[nodiscard]] AotFn find(bytes_view code) const noexcept;
+};
+}  // namespace evmone::baseline
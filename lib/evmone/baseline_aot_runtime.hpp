@@ -0,0 +1,115 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+/// @file
+/// The runtime of the ahead-of-time compiled contracts. Included by the evmone-aotc output.
+
+#include "baseline_aot.hpp"
+#include "baseline_execution.hpp"
+
+namespace evmone::baseline
+{
+/// The implementation of the instruction the compiled code calls through the VM.
+using AotInstructionFn = Result (*)(
+    StackTop stack, int64_t gas_left, ExecutionState& state) noexcept;
+
+/// Checks if the implementation of the legacy instruction is provided by the VM
+/// because it is not defined in the headers or depends on other libraries.
+/// This way the compiled shared objects do not depend on the evmone library symbols.
+constexpr bool is_aot_external(uint8_t op) noexcept
+{
+    switch (op)
+    {
+    case OP_MULMOD:
+    case OP_KECCAK256:
+    case OP_RETURNDATACOPY:
+    case OP_SLOAD:
+    case OP_SSTORE:
+    case OP_CREATE:
+    case OP_CALL:
+    case OP_CALLCODE:
+    case OP_DELEGATECALL:
+    case OP_CREATE2:
+    case OP_STATICCALL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// The support of the compiled code provided by the VM.
+struct AotSupport
+{
+    /// The table of base gas costs of the legacy code in the execution revision.
+    const CostTable& cost_table;
+
+    /// The implementations of the external instructions (see is_aot_external()) by opcode.
+    const AotInstructionFn* instructions;
+};
+
+/// The execution frame of the compiled contract.
+///
+/// The compiled code executes the instructions with step() in the code order and continues
+/// after the jumps at the label of the JUMPDEST at next_position().
+/// The requirements of every instruction are checked like in the Baseline interpreter.
+class AotFrame
+{
+    ExecutionState& m_state;
+    const AotSupport& m_support;
+    const uint8_t* m_code;           ///< The padded code of the contract.
+    const uint256* m_stack_bottom;   ///< The stack bottom.
+    uint256* m_stack_top;            ///< The stack top.
+    code_iterator m_next = nullptr;  ///< The position of the next instruction.
+
+public:
+    int64_t gas;  ///< Gas left.
+
+    AotFrame(ExecutionState& state, int64_t gas_left, const AotSupport& support) noexcept
+      : m_state{state},
+        m_support{support},
+        m_code{state.analysis.baseline->executable_code().data()},
+        m_stack_bottom{state.stack_space.bottom()},
+        m_stack_top{state.stack_space.bottom()},
+        gas{gas_left}
+    {}
+
+    /// Executes the instruction Op at the code position.
+    /// Returns false if the execution terminates.
+    template <Opcode Op>
+    [[release_inline]] bool step(size_t position) noexcept
+    {
+        static_assert(instr::traits[Op].since.has_value(), "EOF instructions are not supported");
+
+        if (const auto status =
+                check_requirements<Op>(m_support.cost_table, gas, m_stack_top, m_stack_bottom);
+            status != EVMC_SUCCESS)
+        {
+            m_state.status = status;
+            return false;
+        }
+
+        const Position pos{m_code + position, m_stack_top};
+        if constexpr (is_aot_external(Op))
+            m_next = invoke(m_support.instructions[Op], pos, gas, m_state);
+        else
+            m_next = invoke(instr::core::impl<Op>, pos, gas, m_state);
+        m_stack_top += instr::traits[Op].stack_height_change;
+        return m_next != nullptr;
+    }
+
+    /// Terminates the execution at the undefined instruction.
+    bool undefined() noexcept
+    {
+        m_state.status = EVMC_UNDEFINED_INSTRUCTION;
+        return false;
+    }
+
+    /// The code position of the next instruction after the jump.
+    [[nodiscard]] size_t next_position() const noexcept
+    {
+        return static_cast<size_t>(m_next - m_code);
+    }
+};
+}  // namespace evmone::baseline
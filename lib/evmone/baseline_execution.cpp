@@ -3,19 +3,17 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "baseline.hpp"
+#include "baseline_aot_runtime.hpp"
+#include "baseline_execution.hpp"
 #include "baseline_instruction_table.hpp"
+#include "baseline_superinstructions.hpp"
 #include "eof.hpp"
 #include "execution_state.hpp"
 #include "instructions.hpp"
 #include "vm.hpp"
+#include <cstring>
 #include <memory>
 
-#ifdef NDEBUG
-#define release_inline gnu::always_inline, msvc::forceinline
-#else
-#define release_inline
-#endif
-
 #if defined(__GNUC__)
 #define ASM_COMMENT(COMMENT) asm("# " #COMMENT)  // NOLINT(hicpp-no-assembler)
 #else
@@ -26,167 +24,261 @@ namespace evmone::baseline
 {
 namespace
 {
-/// Checks instruction requirements before execution.
+/// Checks basic block requirements before execution in the block checks mode.
 ///
-/// This checks:
-/// - if the instruction is defined
-/// - if stack height requirements are fulfilled (stack overflow, stack underflow)
-/// - charges the instruction base gas cost and checks is there is any gas left.
+/// This charges the block base gas cost and checks the stack height requirements of all
+/// instructions of the block at once. The order of checks is the same as in Advanced.
 ///
-/// @tparam         Op            Instruction opcode.
-/// @param          cost_table    Table of base gas costs.
+/// @param          block         The block requirements.
 /// @param [in,out] gas_left      Gas left.
 /// @param          stack_top     Pointer to the stack top item.
 /// @param          stack_bottom  Pointer to the stack bottom.
-///                               The stack height is stack_top - stack_bottom.
 /// @return  Status code with information which check has failed
 ///          or EVMC_SUCCESS if everything is fine.
-template <Opcode Op>
-inline evmc_status_code check_requirements(const CostTable& cost_table, int64_t& gas_left,
+inline evmc_status_code check_block_requirements(const BlockInfo& block, int64_t& gas_left,
     const uint256* stack_top, const uint256* stack_bottom) noexcept
 {
-    static_assert(
-        !instr::has_const_gas_cost(Op) || instr::gas_costs[EVMC_FRONTIER][Op] != instr::undefined,
-        "undefined instructions must not be handled by check_requirements()");
+    if (INTX_UNLIKELY((gas_left -= block.gas_cost) < 0))
+        return EVMC_OUT_OF_GAS;
 
-    auto gas_cost = instr::gas_costs[EVMC_FRONTIER][Op];  // Init assuming const cost.
-    if constexpr (!instr::has_const_gas_cost(Op))
-    {
-        gas_cost = cost_table[Op];  // If not, load the cost from the table.
+    const auto stack_size = stack_top - stack_bottom;
+    if (INTX_UNLIKELY(stack_size < block.stack_req))
+        return EVMC_STACK_UNDERFLOW;
+    if (INTX_UNLIKELY(stack_size + block.stack_max_growth > StackSpace::limit))
+        return EVMC_STACK_OVERFLOW;
 
-        // Negative cost marks an undefined instruction.
-        // This check must be first to produce correct error code.
-        if (INTX_UNLIKELY(gas_cost < 0))
-            return EVMC_UNDEFINED_INSTRUCTION;
-    }
+    return EVMC_SUCCESS;
+}
 
-    // Check stack requirements first. This is order is not required,
-    // but it is nicer because complete gas check may need to inspect operands.
-    if constexpr (instr::traits[Op].stack_height_change > 0)
+/// Returns the requirements of the basic block starting at the given code position.
+inline const BlockInfo& block_at(const ExecutionState& state, code_iterator code_it) noexcept
+{
+    const auto& analysis = *state.analysis.baseline;
+    return analysis.block_at(static_cast<size_t>(code_it - analysis.executable_code().data()));
+}
+
+/// Enters the basic block starting at the given code position in the block checks mode.
+///
+/// The JUMPDEST checks its block requirements when executed so here the blocks starting
+/// with other instructions are checked: the first block and the blocks after splitting
+/// instructions (see splits_block()).
+inline evmc_status_code enter_block(code_iterator code_it, int64_t& gas_left,
+    const uint256* stack_top, const uint256* stack_bottom, const ExecutionState& state) noexcept
+{
+    if (*code_it == OP_JUMPDEST)
+        return EVMC_SUCCESS;
+    return check_block_requirements(block_at(state, code_it), gas_left, stack_top, stack_bottom);
+}
+
+
+/// A helper to invoke the instruction implementation of the given opcode Op.
+///
+/// In the block checks mode only the instructions undefined in the revision are checked.
+/// The requirements of other instructions are checked once per basic block instead:
+/// by the JUMPDEST and after the instructions splitting blocks.
+/// The Costs and the StackChecks are passed to check_requirements().
+template <Opcode Op, bool BlockChecks = false, const CostTable* Costs = nullptr,
+    bool StackChecks = true>
+[[release_inline]] inline Position invoke(const CostTable& cost_table, const uint256* stack_bottom,
+    Position pos, int64_t& gas, ExecutionState& state) noexcept
+{
+    auto status = EVMC_SUCCESS;
+    if constexpr (!BlockChecks)
+        status = check_requirements<Op, Costs, StackChecks>(
+            cost_table, gas, pos.stack_top, stack_bottom);
+    else if constexpr (Op == OP_JUMPDEST)
     {
-        static_assert(instr::traits[Op].stack_height_change == 1,
-            "unexpected instruction with multiple results");
-        if (INTX_UNLIKELY(stack_top == stack_bottom + StackSpace::limit))
-            return EVMC_STACK_OVERFLOW;
+        status = check_block_requirements(
+            block_at(state, pos.code_it), gas, pos.stack_top, stack_bottom);
     }
-    if constexpr (instr::traits[Op].stack_height_required > 0)
+    else if constexpr (!instr::has_const_gas_cost(Op))
     {
-        // Check stack underflow using pointer comparison <= (better optimization).
-        static constexpr auto min_offset = instr::traits[Op].stack_height_required - 1;
-        if (INTX_UNLIKELY(stack_top <= stack_bottom + min_offset))
-            return EVMC_STACK_UNDERFLOW;
+        if (INTX_UNLIKELY(cost_table[Op] < 0))
+            status = EVMC_UNDEFINED_INSTRUCTION;
     }
 
-    if (INTX_UNLIKELY((gas_left -= gas_cost) < 0))
-        return EVMC_OUT_OF_GAS;
+    if (status != EVMC_SUCCESS)
+    {
+        state.status = status;
+        return {nullptr, pos.stack_top};
+    }
+    const auto new_pos = invoke(instr::core::impl<Op>, pos, gas, state);
+    const auto new_stack_top = pos.stack_top + instr::traits[Op].stack_height_change;
 
-    return EVMC_SUCCESS;
+    if constexpr (BlockChecks && splits_block(Op))
+    {
+        if (new_pos != nullptr)
+        {
+            status = enter_block(new_pos, gas, new_stack_top, stack_bottom, state);
+            if (INTX_UNLIKELY(status != EVMC_SUCCESS))
+            {
+                state.status = status;
+                return {nullptr, new_stack_top};
+            }
+        }
+    }
+    return {new_pos, new_stack_top};
 }
 
 
-/// The execution position.
-struct Position
-{
-    code_iterator code_it;  ///< The position in the code.
-    uint256* stack_top;     ///< The pointer to the stack top.
-};
-
-/// Helpers for invoking instruction implementations of different signatures.
+/// Superinstructions implementations.
+///
+/// They execute the fused instruction sequences with the combined requirements check.
+/// When checks fail, the status code is the one the first failing instruction of the sequence
+/// would report. The gas left after a failure is not relevant because it is not returned.
 /// @{
-[[release_inline]] inline code_iterator invoke(void (*instr_fn)(StackTop) noexcept, Position pos,
-    int64_t& /*gas*/, ExecutionState& /*state*/) noexcept
-{
-    instr_fn(pos.stack_top);
-    return pos.code_it + 1;
-}
 
-[[release_inline]] inline code_iterator invoke(
-    Result (*instr_fn)(StackTop, int64_t, ExecutionState&) noexcept, Position pos, int64_t& gas,
-    ExecutionState& state) noexcept
+/// Returns the gas cost of the instruction with the constant cost.
+template <Opcode Op>
+constexpr int64_t const_cost() noexcept
 {
-    const auto o = instr_fn(pos.stack_top, gas, state);
-    gas = o.gas_left;
-    if (o.status != EVMC_SUCCESS)
-    {
-        state.status = o.status;
-        return nullptr;
-    }
-    return pos.code_it + 1;
+    static_assert(instr::has_const_gas_cost(Op));
+    return instr::gas_costs[EVMC_FRONTIER][Op];
 }
 
-[[release_inline]] inline code_iterator invoke(void (*instr_fn)(StackTop, ExecutionState&) noexcept,
-    Position pos, int64_t& /*gas*/, ExecutionState& state) noexcept
+/// Terminates the execution with the given status code.
+[[release_inline]] inline Position terminate(
+    ExecutionState& state, evmc_status_code status, uint256* stack_top) noexcept
 {
-    instr_fn(pos.stack_top, state);
-    return pos.code_it + 1;
+    state.status = status;
+    return {nullptr, stack_top};
 }
 
-[[release_inline]] inline code_iterator invoke(
-    code_iterator (*instr_fn)(StackTop, ExecutionState&, code_iterator) noexcept, Position pos,
-    int64_t& /*gas*/, ExecutionState& state) noexcept
+/// PUSH{Len} JUMP.
+template <size_t Len>
+[[release_inline]] inline Position push_jump(
+    const uint256* stack_bottom, Position pos, int64_t& gas, ExecutionState& state) noexcept
 {
-    return instr_fn(pos.stack_top, state, pos.code_it);
+    if (INTX_UNLIKELY(pos.stack_top == stack_bottom + StackSpace::limit))
+        return terminate(state, EVMC_STACK_OVERFLOW, pos.stack_top);
+    if (INTX_UNLIKELY((gas -= const_cost<OP_PUSH1>() + const_cost<OP_JUMP>()) < 0))
+        return terminate(state, EVMC_OUT_OF_GAS, pos.stack_top);
+
+    const auto dst = instr::core::load_partial_push_data<Len>(pos.code_it + 1);
+    return {instr::core::jump_impl(state, dst), pos.stack_top};
 }
 
-[[release_inline]] inline code_iterator invoke(
-    code_iterator (*instr_fn)(StackTop, code_iterator) noexcept, Position pos, int64_t& /*gas*/,
-    ExecutionState& /*state*/) noexcept
+/// PUSH{Len} JUMPI.
+template <size_t Len>
+[[release_inline]] inline Position push_jumpi(
+    const uint256* stack_bottom, Position pos, int64_t& gas, ExecutionState& state) noexcept
 {
-    return instr_fn(pos.stack_top, pos.code_it);
+    if (INTX_UNLIKELY(pos.stack_top == stack_bottom + StackSpace::limit))
+        return terminate(state, EVMC_STACK_OVERFLOW, pos.stack_top);
+    if (INTX_UNLIKELY(pos.stack_top <= stack_bottom))  // The JUMPI condition is missing.
+    {
+        return terminate(state,
+            gas < const_cost<OP_PUSH1>() ? EVMC_OUT_OF_GAS : EVMC_STACK_UNDERFLOW, pos.stack_top);
+    }
+    if (INTX_UNLIKELY((gas -= const_cost<OP_PUSH1>() + const_cost<OP_JUMPI>()) < 0))
+        return terminate(state, EVMC_OUT_OF_GAS, pos.stack_top);
+
+    const auto next =
+        *pos.stack_top ?
+            instr::core::jump_impl(
+                state, instr::core::load_partial_push_data<Len>(pos.code_it + 1)) :
+            pos.code_it + (Len + 2);
+    return {next, pos.stack_top - 1};
 }
 
-[[release_inline]] inline code_iterator invoke(
-    TermResult (*instr_fn)(StackTop, int64_t, ExecutionState&) noexcept, Position pos, int64_t& gas,
-    ExecutionState& state) noexcept
+/// PUSH1 ADD.
+[[release_inline]] inline Position push1_add(
+    const uint256* stack_bottom, Position pos, int64_t& gas, ExecutionState& state) noexcept
 {
-    const auto result = instr_fn(pos.stack_top, gas, state);
-    gas = result.gas_left;
-    state.status = result.status;
-    return nullptr;
+    if (INTX_UNLIKELY(pos.stack_top == stack_bottom + StackSpace::limit))
+        return terminate(state, EVMC_STACK_OVERFLOW, pos.stack_top);
+    if (INTX_UNLIKELY(pos.stack_top <= stack_bottom))  // The ADD operand is missing.
+    {
+        return terminate(state,
+            gas < const_cost<OP_PUSH1>() ? EVMC_OUT_OF_GAS : EVMC_STACK_UNDERFLOW, pos.stack_top);
+    }
+    if (INTX_UNLIKELY((gas -= const_cost<OP_PUSH1>() + const_cost<OP_ADD>()) < 0))
+        return terminate(state, EVMC_OUT_OF_GAS, pos.stack_top);
+
+    *pos.stack_top += uint256{pos.code_it[1]};
+    return {pos.code_it + 3, pos.stack_top};
 }
 
-[[release_inline]] inline code_iterator invoke(
-    Result (*instr_fn)(StackTop, int64_t, ExecutionState&, code_iterator&) noexcept, Position pos,
-    int64_t& gas, ExecutionState& state) noexcept
+/// ISZERO PUSH{Len} JUMPI.
+template <size_t Len>
+[[release_inline]] inline Position iszero_push_jumpi(
+    const uint256* stack_bottom, Position pos, int64_t& gas, ExecutionState& state) noexcept
 {
-    const auto result = instr_fn(pos.stack_top, gas, state, pos.code_it);
-    gas = result.gas_left;
-    if (result.status != EVMC_SUCCESS)
+    if (INTX_UNLIKELY(pos.stack_top <= stack_bottom))
+        return terminate(state, EVMC_STACK_UNDERFLOW, pos.stack_top);
+    if (INTX_UNLIKELY(pos.stack_top == stack_bottom + StackSpace::limit))  // PUSH overflows.
     {
-        state.status = result.status;
-        return nullptr;
+        return terminate(state,
+            gas < const_cost<OP_ISZERO>() ? EVMC_OUT_OF_GAS : EVMC_STACK_OVERFLOW, pos.stack_top);
     }
-    return pos.code_it;
+    if (INTX_UNLIKELY(
+            (gas -= const_cost<OP_ISZERO>() + const_cost<OP_PUSH1>() + const_cost<OP_JUMPI>()) <
+            0))
+        return terminate(state, EVMC_OUT_OF_GAS, pos.stack_top);
+
+    const auto next =
+        *pos.stack_top == 0 ?
+            instr::core::jump_impl(
+                state, instr::core::load_partial_push_data<Len>(pos.code_it + 2)) :
+            pos.code_it + (Len + 3);
+    return {next, pos.stack_top - 1};
 }
 
-[[release_inline]] inline code_iterator invoke(
-    TermResult (*instr_fn)(StackTop, int64_t, ExecutionState&, code_iterator) noexcept,
-    Position pos, int64_t& gas, ExecutionState& state) noexcept
+/// DUP{N} SWAP{M}.
+template <int N, int M>
+[[release_inline]] inline Position dup_swap(
+    const uint256* stack_bottom, Position pos, int64_t& gas, ExecutionState& state) noexcept
 {
-    const auto result = instr_fn(pos.stack_top, gas, state, pos.code_it);
-    gas = result.gas_left;
-    state.status = result.status;
-    return nullptr;
+    if (INTX_UNLIKELY(pos.stack_top == stack_bottom + StackSpace::limit))
+        return terminate(state, EVMC_STACK_OVERFLOW, pos.stack_top);
+    if (INTX_UNLIKELY(pos.stack_top <= stack_bottom + (N - 1)))
+        return terminate(state, EVMC_STACK_UNDERFLOW, pos.stack_top);
+    if constexpr (M > N)
+    {
+        // The SWAP requires more items than the DUP.
+        if (INTX_UNLIKELY(pos.stack_top <= stack_bottom + (M - 1)))
+        {
+            return terminate(state,
+                gas < const_cost<OP_DUP1>() ? EVMC_OUT_OF_GAS : EVMC_STACK_UNDERFLOW,
+                pos.stack_top);
+        }
+    }
+    if (INTX_UNLIKELY((gas -= const_cost<OP_DUP1>() + const_cost<OP_SWAP1>()) < 0))
+        return terminate(state, EVMC_OUT_OF_GAS, pos.stack_top);
+
+    instr::core::dup<N>(pos.stack_top);
+    instr::core::swap<M>(pos.stack_top + 1);
+    return {pos.code_it + 2, pos.stack_top + 1};
 }
 
-/// A helper to invoke the instruction implementation of the given opcode Op.
-template <Opcode Op>
-[[release_inline]] inline Position invoke(const CostTable& cost_table, const uint256* stack_bottom,
-    Position pos, int64_t& gas, ExecutionState& state) noexcept
+/// A helper to invoke the superinstruction implementation of the given fused opcode Op.
+template <uint8_t Op>
+[[release_inline]] inline Position invoke_fused(
+    const uint256* stack_bottom, Position pos, int64_t& gas, ExecutionState& state) noexcept
 {
-    if (const auto status = check_requirements<Op>(cost_table, gas, pos.stack_top, stack_bottom);
-        status != EVMC_SUCCESS)
+    if constexpr (Op >= OP_PUSH1_JUMP && Op <= OP_PUSH3_JUMP)
+        return push_jump<Op - OP_PUSH1_JUMP + 1>(stack_bottom, pos, gas, state);
+    else if constexpr (Op >= OP_PUSH1_JUMPI && Op <= OP_PUSH3_JUMPI)
+        return push_jumpi<Op - OP_PUSH1_JUMPI + 1>(stack_bottom, pos, gas, state);
+    else if constexpr (Op >= OP_ISZERO_PUSH1_JUMPI && Op <= OP_ISZERO_PUSH3_JUMPI)
+        return iszero_push_jumpi<Op - OP_ISZERO_PUSH1_JUMPI + 1>(stack_bottom, pos, gas, state);
+    else if constexpr (Op >= OP_DUP1_SWAP1 && Op <= OP_DUP4_SWAP4)
     {
-        state.status = status;
-        return {nullptr, pos.stack_top};
+        constexpr auto n = (Op - OP_DUP1_SWAP1) / FUSED_DUP_SWAP_MAX + 1;
+        constexpr auto m = (Op - OP_DUP1_SWAP1) % FUSED_DUP_SWAP_MAX + 1;
+        return dup_swap<n, m>(stack_bottom, pos, gas, state);
+    }
+    else
+    {
+        static_assert(Op == OP_PUSH1_ADD);
+        return push1_add(stack_bottom, pos, gas, state);
     }
-    const auto new_pos = invoke(instr::core::impl<Op>, pos, gas, state);
-    const auto new_stack_top = pos.stack_top + instr::traits[Op].stack_height_change;
-    return {new_pos, new_stack_top};
 }
+/// @}
 
 
-template <bool TracingEnabled>
+template <bool TracingEnabled, bool Superinstructions, bool BlockChecks = false,
+    const CostTable* Costs = nullptr, bool StackChecks = true>
 int64_t dispatch(const CostTable& cost_table, ExecutionState& state, int64_t gas,
     const uint8_t* code, Tracer* tracer = nullptr) noexcept
 {
@@ -195,6 +287,16 @@ int64_t dispatch(const CostTable& cost_table, ExecutionState& state, int64_t gas
     // Code iterator and stack top pointer for interpreter loop.
     Position position{code, stack_bottom};
 
+    if constexpr (BlockChecks)
+    {
+        if (const auto status = enter_block(code, gas, stack_bottom, stack_bottom, state);
+            status != EVMC_SUCCESS)
+        {
+            state.status = status;
+            return gas;
+        }
+    }
+
     while (true)  // Guaranteed to terminate because padded code ends with STOP.
     {
         if constexpr (TracingEnabled)
@@ -211,24 +313,46 @@ int64_t dispatch(const CostTable& cost_table, ExecutionState& state, int64_t gas
         const auto op = *position.code_it;
         switch (op)
         {
-#define ON_OPCODE(OPCODE)                                                                     \
-    case OPCODE:                                                                              \
-        ASM_COMMENT(OPCODE);                                                                  \
-        if (const auto next = invoke<OPCODE>(cost_table, stack_bottom, position, gas, state); \
-            next.code_it == nullptr)                                                          \
-        {                                                                                     \
-            return gas;                                                                       \
-        }                                                                                     \
-        else                                                                                  \
-        {                                                                                     \
-            /* Update current position only when no error,                                    \
-               this improves compiler optimization. */                                        \
-            position = next;                                                                  \
-        }                                                                                     \
+#define ON_OPCODE(OPCODE)                                                                      \
+    case OPCODE:                                                                               \
+        ASM_COMMENT(OPCODE);                                                                   \
+        if (const auto next = invoke<OPCODE, BlockChecks, Costs, StackChecks>(                 \
+                cost_table, stack_bottom, position, gas, state);                               \
+            next.code_it == nullptr)                                                           \
+        {                                                                                      \
+            return gas;                                                                        \
+        }                                                                                      \
+        else                                                                                   \
+        {                                                                                      \
+            /* Update current position only when no error,                                     \
+               this improves compiler optimization. */                                         \
+            position = next;                                                                   \
+        }                                                                                      \
+        break;
+
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED(OPCODE, NAME)                                                          \
+    case OPCODE:                                                                               \
+        if constexpr (!Superinstructions)                                                      \
+        {                                                                                      \
+            state.status = EVMC_UNDEFINED_INSTRUCTION;                                         \
+            return gas;                                                                        \
+        }                                                                                      \
+        else if (const auto next = invoke_fused<OPCODE>(stack_bottom, position, gas, state);   \
+                 next.code_it == nullptr)                                                      \
+        {                                                                                      \
+            return gas;                                                                        \
+        }                                                                                      \
+        else                                                                                   \
+        {                                                                                      \
+            position = next;                                                                   \
+        }                                                                                      \
         break;
 
             MAP_OPCODES
 #undef ON_OPCODE
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED ON_OPCODE_FUSED_DEFAULT
 
         default:
             state.status = EVMC_UNDEFINED_INSTRUCTION;
@@ -239,6 +363,8 @@ int64_t dispatch(const CostTable& cost_table, ExecutionState& state, int64_t gas
 }
 
 #if EVMONE_CGOTO_SUPPORTED
+template <bool Superinstructions, bool BlockChecks = false, const CostTable* Costs = nullptr,
+    bool StackChecks = true>
 int64_t dispatch_cgoto(
     const CostTable& cost_table, ExecutionState& state, int64_t gas, const uint8_t* code) noexcept
 {
@@ -248,10 +374,15 @@ int64_t dispatch_cgoto(
 #define ON_OPCODE(OPCODE) &&TARGET_##OPCODE,
 #undef ON_OPCODE_UNDEFINED
 #define ON_OPCODE_UNDEFINED(_) &&TARGET_OP_UNDEFINED,
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED(OPCODE, _) \
+    (Superinstructions ? &&TARGET_##OPCODE : &&TARGET_OP_UNDEFINED),
         MAP_OPCODES
 #undef ON_OPCODE
 #undef ON_OPCODE_UNDEFINED
 #define ON_OPCODE_UNDEFINED ON_OPCODE_UNDEFINED_DEFAULT
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED ON_OPCODE_FUSED_DEFAULT
     };
     static_assert(std::size(cgoto_table) == 256);
 
@@ -260,35 +391,317 @@ int64_t dispatch_cgoto(
     // Code iterator and stack top pointer for interpreter loop.
     Position position{code, stack_bottom};
 
+    if constexpr (BlockChecks)
+    {
+        if (const auto status = enter_block(code, gas, stack_bottom, stack_bottom, state);
+            status != EVMC_SUCCESS)
+        {
+            state.status = status;
+            return gas;
+        }
+    }
+
+    goto* cgoto_table[*position.code_it];
+
+#define ON_OPCODE(OPCODE)                                                                        \
+    TARGET_##OPCODE : ASM_COMMENT(OPCODE);                                                       \
+    if (const auto next = invoke<OPCODE, BlockChecks, Costs, StackChecks>(                       \
+            cost_table, stack_bottom, position, gas, state);                                     \
+        next.code_it == nullptr)                                                                 \
+    {                                                                                            \
+        return gas;                                                                              \
+    }                                                                                            \
+    else                                                                                         \
+    {                                                                                            \
+        /* Update current position only when no error,                                           \
+           this improves compiler optimization. */                                               \
+        position = next;                                                                         \
+    }                                                                                            \
     goto* cgoto_table[*position.code_it];
 
-#define ON_OPCODE(OPCODE)                                                                 \
-    TARGET_##OPCODE : ASM_COMMENT(OPCODE);                                                \
-    if (const auto next = invoke<OPCODE>(cost_table, stack_bottom, position, gas, state); \
-        next.code_it == nullptr)                                                          \
-    {                                                                                     \
-        return gas;                                                                       \
-    }                                                                                     \
-    else                                                                                  \
-    {                                                                                     \
-        /* Update current position only when no error,                                    \
-           this improves compiler optimization. */                                        \
-        position = next;                                                                  \
-    }                                                                                     \
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED(OPCODE, NAME)                                                      \
+    TARGET_##OPCODE : ASM_COMMENT(NAME);                                                   \
+    if (const auto next = invoke_fused<OPCODE>(stack_bottom, position, gas, state);        \
+        next.code_it == nullptr)                                                           \
+    {                                                                                      \
+        return gas;                                                                        \
+    }                                                                                      \
+    else                                                                                   \
+    {                                                                                      \
+        position = next;                                                                   \
+    }                                                                                      \
     goto* cgoto_table[*position.code_it];
 
     MAP_OPCODES
 #undef ON_OPCODE
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED ON_OPCODE_FUSED_DEFAULT
 
 TARGET_OP_UNDEFINED:
     state.status = EVMC_UNDEFINED_INSTRUCTION;
     return gas;
 }
 #endif
+
+/// Executes the code with the dispatch loop without superinstructions and block checks.
+///
+/// The StackChecks can be disabled for the EOF code: the EOF validation guarantees
+/// the stack underflow and overflow do not happen within a code section
+/// if the stack height at the section entry is checked by CALLF and JUMPF.
+/// Only the gas is checked per instruction then.
+template <bool Cgoto, const CostTable* Costs = nullptr, bool StackChecks = true>
+int64_t dispatch_plain(
+    const CostTable& cost_table, ExecutionState& state, int64_t gas, const uint8_t* code) noexcept
+{
+#if EVMONE_CGOTO_SUPPORTED
+    if constexpr (Cgoto)
+        return dispatch_cgoto<false, false, Costs, StackChecks>(cost_table, state, gas, code);
+    else
+#endif
+        return dispatch<false, false, false, Costs, StackChecks>(cost_table, state, gas, code);
+}
+
+/// The trampoline to the dispatch loop instances specialized for the revision of the legacy code.
+///
+/// The current and the next fork have the instances with the base gas costs known
+/// at compile time because the production nodes execute almost exclusively the current fork.
+/// Other revisions use the generic instance with the cost table lookups.
+template <bool Cgoto>
+int64_t dispatch_legacy(
+    const CostTable& cost_table, ExecutionState& state, int64_t gas, const uint8_t* code) noexcept
+{
+    switch (state.rev)
+    {
+    case EVMC_CANCUN:
+        return dispatch_plain<Cgoto, &LEGACY_COST_TABLE<EVMC_CANCUN>>(cost_table, state, gas, code);
+    case EVMC_PRAGUE:
+        return dispatch_plain<Cgoto, &LEGACY_COST_TABLE<EVMC_PRAGUE>>(cost_table, state, gas, code);
+    default:
+        return dispatch_plain<Cgoto>(cost_table, state, gas, code);
+    }
+}
+
+#if EVMONE_TAILCALL_SUPPORTED
+/// The instruction handler of the tail-call dispatch.
+///
+/// Every instruction is executed by a separate handler function which tail-calls the handler
+/// of the next instruction. The interpreter state is passed in the arguments so it stays
+/// in registers across instructions. The handler returns the gas left when the execution ends.
+using TailcallHandler = int64_t (*)(code_iterator code_it, uint256* stack_top, int64_t gas,
+    ExecutionState& state, const CostTable& cost_table, const uint256* stack_bottom) noexcept;
+
+/// The table of the instruction handlers of the tail-call dispatch indexed by opcode.
+template <bool Superinstructions, bool BlockChecks>
+struct TailcallTable
+{
+    static const TailcallHandler handlers[256];
+};
+
+/// The tail-call dispatch handler of the instruction Op.
+template <Opcode Op, bool Superinstructions, bool BlockChecks>
+int64_t tailcall_op(code_iterator code_it, uint256* stack_top, int64_t gas, ExecutionState& state,
+    const CostTable& cost_table, const uint256* stack_bottom) noexcept
+{
+    const auto next =
+        invoke<Op, BlockChecks>(cost_table, stack_bottom, {code_it, stack_top}, gas, state);
+    if (next.code_it == nullptr)
+        return gas;
+
+    using Table = TailcallTable<Superinstructions, BlockChecks>;
+    const auto next_handler = Table::handlers[*next.code_it];
+    [[clang::musttail]] return next_handler(
+        next.code_it, next.stack_top, gas, state, cost_table, stack_bottom);
+}
+
+/// The tail-call dispatch handler of the superinstruction Op.
+template <uint8_t Op>
+int64_t tailcall_fused(code_iterator code_it, uint256* stack_top, int64_t gas,
+    ExecutionState& state, const CostTable& cost_table, const uint256* stack_bottom) noexcept
+{
+    const auto next = invoke_fused<Op>(stack_bottom, {code_it, stack_top}, gas, state);
+    if (next.code_it == nullptr)
+        return gas;
+
+    const auto next_handler = TailcallTable<true, false>::handlers[*next.code_it];
+    [[clang::musttail]] return next_handler(
+        next.code_it, next.stack_top, gas, state, cost_table, stack_bottom);
+}
+
+/// The tail-call dispatch handler of the undefined instructions.
+int64_t tailcall_undefined(code_iterator /*code_it*/, uint256* /*stack_top*/, int64_t gas,
+    ExecutionState& state, const CostTable& /*cost_table*/,
+    const uint256* /*stack_bottom*/) noexcept
+{
+    state.status = EVMC_UNDEFINED_INSTRUCTION;
+    return gas;
+}
+
+template <bool Superinstructions, bool BlockChecks>
+const TailcallHandler TailcallTable<Superinstructions, BlockChecks>::handlers[256] = {
+#define ON_OPCODE(OPCODE) &tailcall_op<OPCODE, Superinstructions, BlockChecks>,
+#undef ON_OPCODE_UNDEFINED
+#define ON_OPCODE_UNDEFINED(_) &tailcall_undefined,
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED(OPCODE, _) \
+    (Superinstructions ? &tailcall_fused<OPCODE> : &tailcall_undefined),
+    MAP_OPCODES
+#undef ON_OPCODE
+#undef ON_OPCODE_UNDEFINED
+#define ON_OPCODE_UNDEFINED ON_OPCODE_UNDEFINED_DEFAULT
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED ON_OPCODE_FUSED_DEFAULT
+};
+
+template <bool Superinstructions, bool BlockChecks = false>
+int64_t dispatch_tailcall(
+    const CostTable& cost_table, ExecutionState& state, int64_t gas, const uint8_t* code) noexcept
+{
+    const auto stack_bottom = state.stack_space.bottom();
+
+    if constexpr (BlockChecks)
+    {
+        if (const auto status = enter_block(code, gas, stack_bottom, stack_bottom, state);
+            status != EVMC_SUCCESS)
+        {
+            state.status = status;
+            return gas;
+        }
+    }
+
+    return TailcallTable<Superinstructions, BlockChecks>::handlers[*code](
+        code, stack_bottom, gas, state, cost_table, stack_bottom);
+}
+#endif
+}  // namespace
+
+/// The execution context of the native code.
+struct JitContext
+{
+    const CostTable& cost_table;
+    ExecutionState& state;
+    const uint256* stack_bottom;
+    uint256* stack_top;
+    int64_t gas;
+    const uint8_t* code_begin;
+    const JitCode& jit_code;
+};
+
+namespace
+{
+/// The native code stub of the instruction Op. Executes the instruction in the block checks mode.
+template <Opcode Op>
+code_iterator jit_instruction(JitContext& ctx, code_iterator code_it) noexcept
+{
+    const auto next = invoke<Op, true>(
+        ctx.cost_table, ctx.stack_bottom, {code_it, ctx.stack_top}, ctx.gas, ctx.state);
+    ctx.stack_top = next.stack_top;
+    return next.code_it;
+}
+
+/// The native code stub of the undefined instructions.
+code_iterator jit_undefined(JitContext& ctx, code_iterator /*code_it*/) noexcept
+{
+    ctx.state.status = EVMC_UNDEFINED_INSTRUCTION;
+    return nullptr;
+}
+
+/// The native code stub entering the first basic block.
+code_iterator jit_enter(JitContext& ctx, code_iterator code_it) noexcept
+{
+    if (const auto status =
+            enter_block(code_it, ctx.gas, ctx.stack_top, ctx.stack_bottom, ctx.state);
+        status != EVMC_SUCCESS)
+    {
+        ctx.state.status = status;
+        return nullptr;
+    }
+    return code_it;
+}
+
+/// The native code stub resolving the native code address of the jump target.
+const void* jit_resolve(JitContext& ctx, code_iterator code_it) noexcept
+{
+    return ctx.jit_code.address_of(static_cast<size_t>(code_it - ctx.code_begin));
+}
+
+constexpr JitStubs jit_stubs{
+    {
+#define ON_OPCODE(OPCODE) &jit_instruction<OPCODE>,
+#undef ON_OPCODE_UNDEFINED
+#define ON_OPCODE_UNDEFINED(_) &jit_undefined,
+        MAP_OPCODES
+#undef ON_OPCODE
+#undef ON_OPCODE_UNDEFINED
+#define ON_OPCODE_UNDEFINED ON_OPCODE_UNDEFINED_DEFAULT
+    },
+    &jit_enter,
+    &jit_resolve,
+};
+
+/// Executes the native code of the legacy code. The execution is equivalent to the block checks
+/// dispatch.
+int64_t execute_jit(const CostTable& cost_table, ExecutionState& state, int64_t gas,
+    const uint8_t* code, const JitCode& jit_code) noexcept
+{
+    const auto stack_bottom = state.stack_space.bottom();
+    JitContext ctx{cost_table, state, stack_bottom, stack_bottom, gas, code, jit_code};
+    jit_code.entry()(ctx);
+    return ctx.gas;
+}
+
+/// The implementations of the instructions external to the ahead-of-time compiled code.
+constexpr auto aot_instructions = [] {
+    std::array<AotInstructionFn, 256> table{};
+    table[OP_MULMOD] = instr::core::impl<OP_MULMOD>;
+    table[OP_KECCAK256] = instr::core::impl<OP_KECCAK256>;
+    table[OP_RETURNDATACOPY] = instr::core::impl<OP_RETURNDATACOPY>;
+    table[OP_SLOAD] = instr::core::impl<OP_SLOAD>;
+    table[OP_SSTORE] = instr::core::impl<OP_SSTORE>;
+    table[OP_CREATE] = instr::core::impl<OP_CREATE>;
+    table[OP_CALL] = instr::core::impl<OP_CALL>;
+    table[OP_CALLCODE] = instr::core::impl<OP_CALLCODE>;
+    table[OP_DELEGATECALL] = instr::core::impl<OP_DELEGATECALL>;
+    table[OP_CREATE2] = instr::core::impl<OP_CREATE2>;
+    table[OP_STATICCALL] = instr::core::impl<OP_STATICCALL>;
+    return table;
+}();
+static_assert([] {
+    for (size_t op = 0; op < aot_instructions.size(); ++op)
+    {
+        if (is_aot_external(static_cast<uint8_t>(op)) != (aot_instructions[op] != nullptr))
+            return false;
+    }
+    return true;
+}());
+
+/// Makes the result of the nested call referencing the output owned by the frame.
+///
+/// The output is in the EVM memory or the deploy container of the ExecutionState
+/// which is not modified until the state of the call depth is reused. This happens only
+/// after the calling frame has released the result: the return data are cleared before
+/// the next call. Therefore, the output is not copied and the release is not needed.
+evmc_result make_frame_result(
+    evmc_status_code status, int64_t gas_left, int64_t gas_refund, bytes_view output) noexcept
+{
+    evmc_result result{};
+    result.status_code = status;
+    result.gas_left = gas_left;
+    result.gas_refund = gas_refund;
+    result.output_data = output.data();
+    result.output_size = output.size();
+    return result;
+}
 }  // namespace
 
+const JitStubs& get_jit_stubs() noexcept
+{
+    return jit_stubs;
+}
+
 evmc_result execute(VM& vm, const evmc_host_interface& host, evmc_host_context* ctx,
-    evmc_revision rev, const evmc_message& msg, const CodeAnalysis& analysis) noexcept
+    evmc_revision rev, const evmc_message& msg, const CodeAnalysis& analysis,
+    AotFn aot_fn) noexcept
 {
     const auto code = analysis.executable_code();
     const auto code_begin = code.data();
@@ -301,33 +714,98 @@ evmc_result execute(VM& vm, const evmc_host_interface& host, evmc_host_context*
 
     const auto& cost_table = get_baseline_cost_table(state.rev, analysis.eof_header().version);
 
+    const auto superinstructions = analysis.has_superinstructions();
     auto* tracer = vm.get_tracer();
-    if (INTX_UNLIKELY(tracer != nullptr))
+    const auto& jit_code = analysis.jit_code();
+    if (aot_fn != nullptr && tracer == nullptr && analysis.eof_header().version == 0)
+        gas = aot_fn(state, gas, AotSupport{cost_table, aot_instructions.data()});
+    else if (jit_code && tracer == nullptr && analysis.has_block_checks(state.rev))
+        gas = execute_jit(cost_table, state, gas, code_begin, jit_code);
+    else if (INTX_UNLIKELY(tracer != nullptr))
     {
-        tracer->notify_execution_start(state.rev, *state.msg, code);
-        gas = dispatch<true>(cost_table, state, gas, code_begin, tracer);
+        // With superinstructions the tracer sees the original code and only the first instruction
+        // of each fused sequence. The block checks are not used to report exact gas left.
+        tracer->notify_execution_start(
+            state.rev, *state.msg, superinstructions ? analysis.raw_code() : code);
+        gas = superinstructions ?
+                  dispatch<true, true>(cost_table, state, gas, code_begin, tracer) :
+                  dispatch<true, false>(cost_table, state, gas, code_begin, tracer);
     }
     else
     {
+        const auto block_checks = analysis.has_block_checks(state.rev);
+        const auto is_legacy = analysis.eof_header().version == 0;
+#if EVMONE_TAILCALL_SUPPORTED
+        if (vm.tailcall)
+        {
+            if (block_checks)
+                gas = dispatch_tailcall<false, true>(cost_table, state, gas, code_begin);
+            else if (superinstructions)
+                gas = dispatch_tailcall<true>(cost_table, state, gas, code_begin);
+            else
+                gas = dispatch_tailcall<false>(cost_table, state, gas, code_begin);
+        }
+        else
+#endif
 #if EVMONE_CGOTO_SUPPORTED
         if (vm.cgoto)
-            gas = dispatch_cgoto(cost_table, state, gas, code_begin);
+        {
+            if (block_checks)
+                gas = dispatch_cgoto<false, true>(cost_table, state, gas, code_begin);
+            else if (superinstructions)
+                gas = dispatch_cgoto<true>(cost_table, state, gas, code_begin);
+            else if (is_legacy)
+                gas = dispatch_legacy<true>(cost_table, state, gas, code_begin);
+            else
+                gas = dispatch_plain<true, nullptr, false>(cost_table, state, gas, code_begin);
+        }
         else
 #endif
-            gas = dispatch<false>(cost_table, state, gas, code_begin);
+        {
+            if (block_checks)
+                gas = dispatch<false, false, true>(cost_table, state, gas, code_begin);
+            else if (superinstructions)
+                gas = dispatch<false, true>(cost_table, state, gas, code_begin);
+            else if (is_legacy)
+                gas = dispatch_legacy<false>(cost_table, state, gas, code_begin);
+            else
+                gas = dispatch_plain<false, nullptr, false>(cost_table, state, gas, code_begin);
+        }
     }
 
     const auto gas_left = (state.status == EVMC_SUCCESS || state.status == EVMC_REVERT) ? gas : 0;
     const auto gas_refund = (state.status == EVMC_SUCCESS) ? state.gas_refund : 0;
 
     assert(state.output_size != 0 || state.output_offset == 0);
-    const auto result =
-        (state.deploy_container.has_value() ?
-                evmc::make_result(state.status, gas_left, gas_refund,
-                    state.deploy_container->data(), state.deploy_container->size()) :
-                evmc::make_result(state.status, gas_left, gas_refund,
-                    state.output_size != 0 ? &state.memory[state.output_offset] : nullptr,
-                    state.output_size));
+    const auto output =
+        state.deploy_container.has_value() ?
+            *state.deploy_container :
+            bytes_view{state.output_size != 0 ? &state.memory[state.output_offset] : nullptr,
+                state.output_size};
+
+    // The output of the nested call is passed to the calling frame in the output buffer
+    // of the arena to not allocate. The top-level result may be kept arbitrarily long
+    // and released in any thread so it gets the copy.
+    evmc_result result;
+    if (msg.depth == 0 || output.empty())
+    {
+        result =
+            evmc::make_result(state.status, gas_left, gas_refund, output.data(), output.size());
+    }
+    else if (vm.zero_copy_output)
+        result = make_frame_result(state.status, gas_left, gas_refund, output);
+    else
+    {
+        auto* buffer = output.data();
+        if (!state.deploy_container.has_value())  // The deploy container is in the buffer already.
+        {
+            auto* const output_buffer = state.arena.allocate_output(output.size());
+            std::memcpy(output_buffer, output.data(), output.size());
+            buffer = output_buffer;
+        }
+        result =
+            state.arena.lease_output(state.status, gas_left, gas_refund, buffer, output.size());
+    }
 
     if (INTX_UNLIKELY(tracer != nullptr))
         tracer->notify_execution_end(result);
@@ -353,7 +831,39 @@ evmc_result execute(evmc_vm* c_vm, const evmc_host_interface* host, evmc_host_co
             return evmc_make_result(EVMC_CONTRACT_VALIDATION_FAILURE, 0, 0, nullptr, 0);
     }
 
-    const auto code_analysis = analyze(container, eof_enabled);
-    return execute(*vm, *host, ctx, rev, *msg, code_analysis);
+    // The superinstructions, the block checks and the native code are not used when tracing
+    // to report every executed instruction with exact gas left.
+    const auto tracing = vm->get_tracer() != nullptr;
+    AnalysisOptions options{.superinstructions = vm->superinstructions && !tracing};
+    if ((vm->block_checks || vm->jit) && !tracing)
+    {
+        options.block_checks = vm->block_checks;
+        options.jit = vm->jit;
+        options.rev = rev;
+    }
+
+    // The initcode is usually executed once so it is not worth caching or compiling.
+    const auto is_initcode =
+        msg->kind == EVMC_CREATE || msg->kind == EVMC_CREATE2 || msg->kind == EVMC_EOFCREATE;
+
+    const auto& aot_registry = vm->get_aot_registry();
+    const auto aot_fn =
+        (!aot_registry.empty() && !tracing && !is_initcode && !is_eof_container(container)) ?
+            aot_registry.find(container) :
+            nullptr;
+
+    if (vm->get_analysis_cache().enabled() && !is_initcode)
+    {
+        // Keep the shared reference for the whole execution because nested calls
+        // or other threads may evict the entry from the cache.
+        const auto cached_analysis = vm->get_cached_analysis(container, eof_enabled, options);
+        return execute(*vm, *host, ctx, rev, *msg, *cached_analysis, aot_fn);
+    }
+
+    // Compiling the native code of the analysis used once costs more than it saves,
+    // so only the analyses kept in the cache are compiled.
+    options.jit = false;
+    const auto code_analysis = analyze(container, eof_enabled, options);
+    return execute(*vm, *host, ctx, rev, *msg, code_analysis, aot_fn);
 }
 }  // namespace evmone::baseline
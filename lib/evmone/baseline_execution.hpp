@@ -0,0 +1,187 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+/// @file
+/// The Baseline instruction execution helpers shared by the interpreter dispatch
+/// and the ahead-of-time compiled code.
+
+#include "baseline_instruction_table.hpp"
+#include "execution_state.hpp"
+#include "instructions.hpp"
+#include <cassert>
+
+#ifdef NDEBUG
+#define release_inline gnu::always_inline, msvc::forceinline
+#else
+#define release_inline
+#endif
+
+namespace evmone::baseline
+{
+/// Checks instruction requirements before execution.
+///
+/// This checks:
+/// - if the instruction is defined
+/// - if stack height requirements are fulfilled (stack overflow, stack underflow)
+/// - charges the instruction base gas cost and checks is there is any gas left.
+///
+/// @tparam         Op            Instruction opcode.
+/// @tparam         Costs         The table of base gas costs known at compile time or null
+///                               to use the cost_table.
+/// @tparam         StackChecks   Check the stack requirements? The stack checks are skipped
+///                               for the validated EOF code (see dispatch_plain()).
+/// @param          cost_table    Table of base gas costs.
+/// @param [in,out] gas_left      Gas left.
+/// @param          stack_top     Pointer to the stack top item.
+/// @param          stack_bottom  Pointer to the stack bottom.
+///                               The stack height is stack_top - stack_bottom.
+/// @return  Status code with information which check has failed
+///          or EVMC_SUCCESS if everything is fine.
+template <Opcode Op, const CostTable* Costs = nullptr, bool StackChecks = true>
+inline evmc_status_code check_requirements(const CostTable& cost_table, int64_t& gas_left,
+    const uint256* stack_top, const uint256* stack_bottom) noexcept
+{
+    static_assert(
+        !instr::has_const_gas_cost(Op) || instr::gas_costs[EVMC_FRONTIER][Op] != instr::undefined,
+        "undefined instructions must not be handled by check_requirements()");
+
+    auto gas_cost = instr::gas_costs[EVMC_FRONTIER][Op];  // Init assuming const cost.
+    if constexpr (!instr::has_const_gas_cost(Op))
+    {
+        // If not, load the cost from the table. In the revision-specialized dispatch
+        // the cost is known at compile time.
+        if constexpr (Costs != nullptr)
+        {
+            constexpr auto cost = (*Costs)[Op];
+            gas_cost = cost;
+        }
+        else
+            gas_cost = cost_table[Op];
+
+        // Negative cost marks an undefined instruction.
+        // This check must be first to produce correct error code.
+        if (INTX_UNLIKELY(gas_cost < 0))
+            return EVMC_UNDEFINED_INSTRUCTION;
+    }
+
+    // Check stack requirements first. This is order is not required,
+    // but it is nicer because complete gas check may need to inspect operands.
+    if constexpr (StackChecks)
+    {
+        if constexpr (instr::traits[Op].stack_height_change > 0)
+        {
+            static_assert(instr::traits[Op].stack_height_change == 1,
+                "unexpected instruction with multiple results");
+            if (INTX_UNLIKELY(stack_top == stack_bottom + StackSpace::limit))
+                return EVMC_STACK_OVERFLOW;
+        }
+        if constexpr (instr::traits[Op].stack_height_required > 0)
+        {
+            // Check stack underflow using pointer comparison <= (better optimization).
+            static constexpr auto min_offset = instr::traits[Op].stack_height_required - 1;
+            if (INTX_UNLIKELY(stack_top <= stack_bottom + min_offset))
+                return EVMC_STACK_UNDERFLOW;
+        }
+    }
+    else
+    {
+        // The EOF validation guarantees the stack requirements within the code section.
+        [[maybe_unused]] const auto stack_size = stack_top - stack_bottom;
+        assert(stack_size >= instr::traits[Op].stack_height_required);
+        assert(stack_size + (instr::traits[Op].stack_height_change > 0) <= StackSpace::limit);
+    }
+
+    if (INTX_UNLIKELY((gas_left -= gas_cost) < 0))
+        return EVMC_OUT_OF_GAS;
+
+    return EVMC_SUCCESS;
+}
+
+/// The execution position.
+struct Position
+{
+    code_iterator code_it;  ///< The position in the code.
+    uint256* stack_top;     ///< The pointer to the stack top.
+};
+
+/// Helpers for invoking instruction implementations of different signatures.
+/// @{
+[[release_inline]] inline code_iterator invoke(void (*instr_fn)(StackTop) noexcept, Position pos,
+    int64_t& /*gas*/, ExecutionState& /*state*/) noexcept
+{
+    instr_fn(pos.stack_top);
+    return pos.code_it + 1;
+}
+
+[[release_inline]] inline code_iterator invoke(
+    Result (*instr_fn)(StackTop, int64_t, ExecutionState&) noexcept, Position pos, int64_t& gas,
+    ExecutionState& state) noexcept
+{
+    const auto o = instr_fn(pos.stack_top, gas, state);
+    gas = o.gas_left;
+    if (o.status != EVMC_SUCCESS)
+    {
+        state.status = o.status;
+        return nullptr;
+    }
+    return pos.code_it + 1;
+}
+
+[[release_inline]] inline code_iterator invoke(void (*instr_fn)(StackTop, ExecutionState&) noexcept,
+    Position pos, int64_t& /*gas*/, ExecutionState& state) noexcept
+{
+    instr_fn(pos.stack_top, state);
+    return pos.code_it + 1;
+}
+
+[[release_inline]] inline code_iterator invoke(
+    code_iterator (*instr_fn)(StackTop, ExecutionState&, code_iterator) noexcept, Position pos,
+    int64_t& /*gas*/, ExecutionState& state) noexcept
+{
+    return instr_fn(pos.stack_top, state, pos.code_it);
+}
+
+[[release_inline]] inline code_iterator invoke(
+    code_iterator (*instr_fn)(StackTop, code_iterator) noexcept, Position pos, int64_t& /*gas*/,
+    ExecutionState& /*state*/) noexcept
+{
+    return instr_fn(pos.stack_top, pos.code_it);
+}
+
+[[release_inline]] inline code_iterator invoke(
+    TermResult (*instr_fn)(StackTop, int64_t, ExecutionState&) noexcept, Position pos, int64_t& gas,
+    ExecutionState& state) noexcept
+{
+    const auto result = instr_fn(pos.stack_top, gas, state);
+    gas = result.gas_left;
+    state.status = result.status;
+    return nullptr;
+}
+
+[[release_inline]] inline code_iterator invoke(
+    Result (*instr_fn)(StackTop, int64_t, ExecutionState&, code_iterator&) noexcept, Position pos,
+    int64_t& gas, ExecutionState& state) noexcept
+{
+    const auto result = instr_fn(pos.stack_top, gas, state, pos.code_it);
+    gas = result.gas_left;
+    if (result.status != EVMC_SUCCESS)
+    {
+        state.status = result.status;
+        return nullptr;
+    }
+    return pos.code_it;
+}
+
+[[release_inline]] inline code_iterator invoke(
+    TermResult (*instr_fn)(StackTop, int64_t, ExecutionState&, code_iterator) noexcept,
+    Position pos, int64_t& gas, ExecutionState& state) noexcept
+{
+    const auto result = instr_fn(pos.stack_top, gas, state, pos.code_it);
+    gas = result.gas_left;
+    state.status = result.status;
+    return nullptr;
+}
+/// @}
+}  // namespace evmone::baseline
@@ -3,7 +3,6 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "baseline_instruction_table.hpp"
-#include "instructions_traits.hpp"
 
 namespace evmone::baseline
 {
@@ -13,15 +12,7 @@ consteval auto build_cost_tables(bool eof) noexcept
 {
     std::array<CostTable, EVMC_MAX_REVISION + 1> tables{};
     for (size_t r = EVMC_FRONTIER; r <= EVMC_MAX_REVISION; ++r)
-    {
-        auto& table = tables[r];
-        for (size_t op = 0; op < table.size(); ++op)
-        {
-            const auto& tr = instr::traits[op];
-            const auto since = eof ? tr.eof_since : tr.since;
-            table[op] = (since && r >= *since) ? instr::gas_costs[r][op] : instr::undefined;
-        }
-    }
+        tables[r] = build_cost_table(static_cast<evmc_revision>(r), eof);
     return tables;
 }
 
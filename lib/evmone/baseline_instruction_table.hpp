@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include "instructions_traits.hpp"
 #include <evmc/evmc.h>
 #include <array>
 
@@ -10,6 +11,25 @@ namespace evmone::baseline
 {
 using CostTable = std::array<int16_t, 256>;
 
+/// Builds the table of base gas costs of the legacy or EOF code in the revision.
+/// The undefined instructions have the instr::undefined cost.
+consteval CostTable build_cost_table(evmc_revision rev, bool eof) noexcept
+{
+    CostTable table{};
+    for (size_t op = 0; op < table.size(); ++op)
+    {
+        const auto& tr = instr::traits[op];
+        const auto since = eof ? tr.eof_since : tr.since;
+        table[op] = (since && rev >= *since) ? instr::gas_costs[rev][op] : instr::undefined;
+    }
+    return table;
+}
+
+/// The table of base gas costs of the legacy code in the revision Rev available
+/// at compile time for the revision-specialized dispatch loops.
+template <evmc_revision Rev>
+inline constexpr CostTable LEGACY_COST_TABLE = build_cost_table(Rev, false);
+
 const CostTable& get_baseline_cost_table(evmc_revision rev, uint8_t eof_version) noexcept;
 
 const CostTable& get_baseline_legacy_cost_table(evmc_revision rev) noexcept;
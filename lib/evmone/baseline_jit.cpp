@@ -0,0 +1,184 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "baseline_jit.hpp"
+#include "instructions_opcodes.hpp"
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+
+#if EVMONE_JIT_SUPPORTED
+#include <sys/mman.h>
+#endif
+
+namespace evmone::baseline
+{
+#if EVMONE_JIT_SUPPORTED
+namespace
+{
+/// The x86-64 machine code assembler of the native code.
+///
+/// The native code keeps the JitContext pointer in the callee-saved RBX register.
+/// The stubs are called with the context pointer and the code position in RDI and RSI
+/// (System V ABI). The code starts with the shared exit sequence at offset 0.
+class Assembler
+{
+    std::vector<uint8_t> m_code;
+
+    void emit(std::initializer_list<uint8_t> bytes) { m_code.insert(m_code.end(), bytes); }
+
+    void emit_imm64(uint64_t value)
+    {
+        for (size_t i = 0; i < sizeof(value); ++i)
+            m_code.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+
+    void emit_imm64(const void* ptr) { emit_imm64(reinterpret_cast<uint64_t>(ptr)); }
+
+public:
+    /// The offset of the exit sequence.
+    static constexpr size_t EXIT_OFFSET = 0;
+
+    /// The offset of the entry: after the exit sequence.
+    static constexpr size_t ENTRY_OFFSET = 2;
+
+    /// The size of the code emitted by call_stub().
+    static constexpr size_t CALL_STUB_SIZE = 34;
+
+    explicit Assembler(size_t capacity)
+    {
+        m_code.reserve(capacity);
+        emit({0x5b, 0xc3});  // pop rbx; ret
+        assert(m_code.size() == ENTRY_OFFSET);
+        emit({0x53});              // push rbx
+        emit({0x48, 0x89, 0xfb});  // mov rbx, rdi
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return m_code.size(); }
+
+    [[nodiscard]] const uint8_t* data() const noexcept { return m_code.data(); }
+
+    /// Calls the stub for the code position and exits if it returns null.
+    void call_stub(JitStub stub, const uint8_t* code_it)
+    {
+        emit({0x48, 0x89, 0xdf});  // mov rdi, rbx
+        emit({0x48, 0xbe});        // mov rsi, imm64
+        emit_imm64(code_it);
+        emit({0x48, 0xb8});  // mov rax, imm64
+        emit_imm64(reinterpret_cast<const void*>(stub));
+        emit({0xff, 0xd0});        // call rax
+        emit({0x48, 0x85, 0xc0});  // test rax, rax
+        emit({0x0f, 0x84});        // jz rel32
+        const auto rel = static_cast<int64_t>(EXIT_OFFSET) - static_cast<int64_t>(size() + 4);
+        const auto rel32 = static_cast<uint32_t>(static_cast<int32_t>(rel));
+        for (size_t i = 0; i < sizeof(rel32); ++i)
+            m_code.push_back(static_cast<uint8_t>(rel32 >> (i * 8)));
+    }
+
+    /// Jumps to the native code of the code position returned by the previous stub.
+    void dispatch(JitResolveStub resolve)
+    {
+        emit({0x48, 0x89, 0xdf});  // mov rdi, rbx
+        emit({0x48, 0x89, 0xc6});  // mov rsi, rax
+        emit({0x48, 0xb8});        // mov rax, imm64
+        emit_imm64(reinterpret_cast<const void*>(resolve));
+        emit({0xff, 0xd0});  // call rax
+        emit({0xff, 0xe0});  // jmp rax
+    }
+};
+}  // namespace
+
+JitCode JitCode::compile(bytes_view code, const JitStubs& stubs) noexcept
+{
+    // The code must be padded (see CodeAnalysis::CODE_PADDING).
+    const auto code_begin = code.data();
+
+    // The native code size estimation: each instruction calls the stub.
+    Assembler as{Assembler::ENTRY_OFFSET + 4 + (code.size() + 2) * Assembler::CALL_STUB_SIZE};
+
+    JitCode jit;
+    jit.m_offsets.resize(code.size() + 1);
+
+    as.call_stub(stubs.enter, code_begin);
+    size_t i = 0;
+    for (; i < code.size(); ++i)
+    {
+        const auto op = code[i];
+        jit.m_offsets[i] = static_cast<uint32_t>(as.size());
+        as.call_stub(stubs.instructions[op], &code_begin[i]);
+        if (op == OP_JUMP || op == OP_JUMPI)
+            as.dispatch(stubs.resolve);
+        else if (op >= OP_PUSH1 && op <= OP_PUSH32)
+            i += op - OP_PUSH0;
+    }
+
+    // The final STOP from the code padding. It is after the code end
+    // if the code ends with incomplete PUSH data.
+    if (i == code.size())
+        jit.m_offsets[i] = static_cast<uint32_t>(as.size());
+    as.call_stub(stubs.instructions[OP_STOP], &code_begin[i]);
+
+    if (as.size() > UINT32_MAX)
+        return {};
+
+    auto* const mem =
+        mmap(nullptr, as.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+        return {};
+    std::memcpy(mem, as.data(), as.size());
+    if (mprotect(mem, as.size(), PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(mem, as.size());
+        return {};
+    }
+
+    jit.m_code = static_cast<uint8_t*>(mem);
+    jit.m_size = as.size();
+    return jit;
+}
+
+JitCode::~JitCode()
+{
+    if (m_code != nullptr)
+        munmap(m_code, m_size);
+}
+
+JitCode::EntryFn JitCode::entry() const noexcept
+{
+    assert(m_code != nullptr);
+    return reinterpret_cast<EntryFn>(m_code + Assembler::ENTRY_OFFSET);
+}
+#else
+JitCode JitCode::compile(bytes_view /*code*/, const JitStubs& /*stubs*/) noexcept
+{
+    return {};
+}
+
+JitCode::~JitCode() = default;
+
+JitCode::EntryFn JitCode::entry() const noexcept
+{
+    return nullptr;
+}
+#endif
+
+JitCode::JitCode(JitCode&& other) noexcept
+  : m_code{std::exchange(other.m_code, nullptr)},
+    m_size{std::exchange(other.m_size, 0)},
+    m_offsets{std::move(other.m_offsets)}
+{}
+
+JitCode& JitCode::operator=(JitCode&& other) noexcept
+{
+    if (this != &other)
+    {
+        JitCode tmp{std::move(other)};
+        std::swap(m_code, tmp.m_code);
+        std::swap(m_size, tmp.m_size);
+        std::swap(m_offsets, tmp.m_offsets);
+    }
+    return *this;
+}
+}  // namespace evmone::baseline
@@ -0,0 +1,88 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <evmc/bytes.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__linux__)
+#define EVMONE_JIT_SUPPORTED 1
+#else
+#define EVMONE_JIT_SUPPORTED 0
+#endif
+
+namespace evmone::baseline
+{
+using evmc::bytes_view;
+
+/// The execution context of the native code, defined by the Baseline execution.
+struct JitContext;
+
+/// The native code stub executing the instruction at the given code position.
+/// Returns the position of the next instruction or null if the execution terminates.
+using JitStub = const uint8_t* (*)(JitContext& ctx, const uint8_t* code_it) noexcept;
+
+/// The native code stub returning the native code address of the given code position.
+using JitResolveStub = const void* (*)(JitContext& ctx, const uint8_t* code_it) noexcept;
+
+/// The precompiled stubs the native code is stitched from.
+struct JitStubs
+{
+    /// The instruction stubs indexed by opcode. They execute the instructions with the block
+    /// checks (see BlockInfo).
+    JitStub instructions[256];
+
+    /// The stub checking the requirements of the first basic block of the code.
+    JitStub enter;
+
+    /// The stub resolving the targets of the dynamic jumps.
+    JitResolveStub resolve;
+};
+
+/// Returns the stubs provided by the Baseline execution.
+const JitStubs& get_jit_stubs() noexcept;
+
+/// The native x86-64 code of the legacy code.
+///
+/// The code executing the instructions one after another is emitted in a single executable buffer
+/// with the instruction stubs called directly, the code positions patched in as immediate values.
+/// Only the JUMP and JUMPI continue at the dynamically resolved address.
+class JitCode
+{
+    uint8_t* m_code = nullptr;  ///< The executable buffer.
+    size_t m_size = 0;          ///< The size of the executable buffer.
+
+    /// The offsets of the native code of the instructions by the code position.
+    std::vector<uint32_t> m_offsets;
+
+public:
+    /// The native code entry function.
+    using EntryFn = void (*)(JitContext& ctx) noexcept;
+
+    JitCode() noexcept = default;
+    JitCode(JitCode&& other) noexcept;
+    JitCode& operator=(JitCode&& other) noexcept;
+    ~JitCode();
+
+    /// Compiles the padded legacy code to the native code.
+    /// Returns empty JitCode if the native code cannot be created on this platform.
+    static JitCode compile(bytes_view code, const JitStubs& stubs) noexcept;
+
+    [[nodiscard]] explicit operator bool() const noexcept { return m_code != nullptr; }
+
+    /// The size of the native code.
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+    /// The native code entry function.
+    [[nodiscard]] EntryFn entry() const noexcept;
+
+    /// Returns the native code address of the instruction at the given code position.
+    [[nodiscard]] const void* address_of(size_t position) const noexcept
+    {
+        return m_code + m_offsets[position];
+    }
+};
+}  // namespace evmone::baseline
@@ -0,0 +1,62 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "instructions_xmacro.hpp"
+#include <cstdint>
+
+namespace evmone::baseline
+{
+/// The opcodes of the Baseline superinstructions.
+///
+/// A superinstruction executes a common sequence of instructions with a single dispatch
+/// and a single combined requirements check. The opcodes occupy undefined opcode slots
+/// (see ON_OPCODE_FUSED in MAP_OPCODES) and only exist in the legacy code rewritten by
+/// the analysis with the superinstructions enabled. Only the first opcode of the sequence
+/// is replaced, the rest of the code stays unmodified.
+enum FusedOpcode : uint8_t
+{
+#define ON_OPCODE(OPCODE)
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED(OPCODE, NAME) OP_##NAME = OPCODE,
+    MAP_OPCODES
+#undef ON_OPCODE
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED ON_OPCODE_FUSED_DEFAULT
+};
+
+/// The undefined opcode replacing the undefined instructions of the original code which
+/// collide with the superinstruction opcodes. It is not used for any superinstruction.
+constexpr uint8_t OP_UNDEFINED_REPLACEMENT = 0xa5;
+
+/// The max number of data bytes of the PUSH instruction in a superinstruction.
+constexpr int FUSED_PUSH_MAX_SIZE = 3;
+
+/// The max N and M of the fused DUPN SWAPM instructions.
+constexpr int FUSED_DUP_SWAP_MAX = 4;
+
+/// Checks if the opcode is reserved for a superinstruction.
+constexpr bool is_fused_opcode(uint8_t op) noexcept
+{
+    switch (op)
+    {
+#define ON_OPCODE(OPCODE)
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED(OPCODE, NAME) case OPCODE:
+        MAP_OPCODES
+#undef ON_OPCODE
+#undef ON_OPCODE_FUSED
+#define ON_OPCODE_FUSED ON_OPCODE_FUSED_DEFAULT
+        return true;
+    default:
+        return false;
+    }
+}
+
+static_assert(!is_fused_opcode(OP_UNDEFINED_REPLACEMENT));
+static_assert(OP_PUSH3_JUMP - OP_PUSH1_JUMP + 1 == FUSED_PUSH_MAX_SIZE);
+static_assert(OP_PUSH3_JUMPI - OP_PUSH1_JUMPI + 1 == FUSED_PUSH_MAX_SIZE);
+static_assert(OP_ISZERO_PUSH3_JUMPI - OP_ISZERO_PUSH1_JUMPI + 1 == FUSED_PUSH_MAX_SIZE);
+static_assert(OP_DUP4_SWAP4 - OP_DUP1_SWAP1 + 1 == FUSED_DUP_SWAP_MAX * FUSED_DUP_SWAP_MAX);
+}  // namespace evmone::baseline
@@ -853,7 +853,7 @@ EOF1Header read_valid_eof1_header(bytes_view container)
     return header;
 }
 
-bool append_data_section(bytes& container, bytes_view aux_data)
+bool append_data_section(uint8_t* out, bytes_view container, bytes_view aux_data)
 {
     const auto header = read_valid_eof1_header(container);
 
@@ -869,12 +869,13 @@ bool append_data_section(bytes& container, bytes_view aux_data)
         return false;
 
     // Appending aux_data to the end, assuming data section is always the last one.
-    container.append(aux_data);
+    std::copy(container.begin(), container.end(), out);
+    std::copy(aux_data.begin(), aux_data.end(), out + container.size());
 
     // Update data size
     const auto data_size_pos = header.data_size_position();
-    container[data_size_pos] = static_cast<uint8_t>(new_data_size >> 8);
-    container[data_size_pos + 1] = static_cast<uint8_t>(new_data_size);
+    out[data_size_pos] = static_cast<uint8_t>(new_data_size >> 8);
+    out[data_size_pos + 1] = static_cast<uint8_t>(new_data_size);
 
     return true;
 }
@@ -140,9 +140,9 @@ struct EOF1Header
 /// (must be true for all EOF contracts on-chain)
 [[nodiscard]] EVMC_EXPORT EOF1Header read_valid_eof1_header(bytes_view container);
 
-/// Modifies container by appending aux_data to data section and updating data section size
-/// in the header.
-bool append_data_section(bytes& container, bytes_view aux_data);
+/// Writes the container with aux_data appended to data section and with updated data section size
+/// in the header to the output buffer of the size of the container plus aux_data.
+bool append_data_section(uint8_t* out, bytes_view container, bytes_view aux_data);
 
 enum class EOFValidationError
 {
@@ -0,0 +1,164 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "execution_state.hpp"
+#include <cassert>
+#include <new>
+#include <utility>
+
+#if EVMONE_MAPPED_MEMORY_SUPPORTED
+#include <sys/mman.h>
+#endif
+
+namespace evmone
+{
+uint8_t* Memory::map() noexcept
+{
+#if EVMONE_MAPPED_MEMORY_SUPPORTED
+    // Only reserve the address space. The pages are allocated by the OS on the first write.
+    auto* const p = mmap(nullptr, mapped_capacity, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return p != MAP_FAILED ? static_cast<uint8_t*>(p) : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+void Memory::unmap([[maybe_unused]] uint8_t* p) noexcept
+{
+#if EVMONE_MAPPED_MEMORY_SUPPORTED
+    munmap(p, mapped_capacity);
+#endif
+}
+
+bool Memory::discard([[maybe_unused]] uint8_t* begin, [[maybe_unused]] size_t size) noexcept
+{
+#if EVMONE_MAPPED_MEMORY_SUPPORTED && defined(__linux__)
+    // The private anonymous pages are filled with zeros on the next access.
+    return madvise(begin, size, MADV_DONTNEED) == 0;
+#elif EVMONE_MAPPED_MEMORY_SUPPORTED
+    // Elsewhere MADV_DONTNEED may keep the contents so map the fresh pages in place.
+    return mmap(begin, size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0) != MAP_FAILED;
+#else
+    return false;
+#endif
+}
+
+FrameArena::FrameArena(FrameArena&& other) noexcept
+  : m_block{std::move(other.m_block)},
+    m_block_size{std::exchange(other.m_block_size, 0)},
+    m_used{std::exchange(other.m_used, 0)},
+    m_overflow{std::exchange(other.m_overflow, {})},
+    m_overflow_size{std::exchange(other.m_overflow_size, 0)},
+    m_lease{std::exchange(other.m_lease, nullptr)}
+{
+    if (m_lease != nullptr)
+        m_lease->arena = this;
+}
+
+FrameArena& FrameArena::operator=(FrameArena&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    if (m_lease != nullptr)
+        detach_lease();
+    m_block = std::move(other.m_block);
+    m_block_size = std::exchange(other.m_block_size, 0);
+    m_used = std::exchange(other.m_used, 0);
+    m_overflow = std::exchange(other.m_overflow, {});
+    m_overflow_size = std::exchange(other.m_overflow_size, 0);
+    m_lease = std::exchange(other.m_lease, nullptr);
+    if (m_lease != nullptr)
+        m_lease->arena = this;
+    return *this;
+}
+
+FrameArena::~FrameArena()
+{
+    if (m_lease != nullptr)
+        detach_lease();
+}
+
+uint8_t* FrameArena::allocate_slow(size_t size) noexcept
+{
+    if (m_block == nullptr)
+    {
+        // The first allocation creates the main block.
+        m_block_size = std::max(size, min_block_size);
+        m_block.reset(new uint8_t[m_block_size]);
+        m_used = size;
+        return m_block.get();
+    }
+
+    auto& block = m_overflow.emplace_back(new uint8_t[size]);
+    m_overflow_size += size;
+    return block.get();
+}
+
+void FrameArena::detach_lease() noexcept
+{
+    auto* const block = m_lease->block;
+    m_lease->arena = nullptr;
+    m_lease = nullptr;
+
+    // The block is freed by the result release.
+    if (block == m_block.get())
+    {
+        (void)m_block.release();
+        return;
+    }
+    for (auto& b : m_overflow)
+    {
+        if (b.get() == block)
+            (void)b.release();
+    }
+}
+
+void FrameArena::merge_blocks() noexcept
+{
+    m_block_size += m_overflow_size;
+    m_block.reset(new uint8_t[m_block_size]);
+    m_overflow.clear();
+    m_overflow_size = 0;
+}
+
+uint8_t* FrameArena::allocate_output(size_t size) noexcept
+{
+    // The header is placed right before the output keeping the alignment of the output.
+    constexpr auto header_size = align(sizeof(OutputHeader));
+
+    auto* const p = allocate(header_size + size);
+    const auto in_overflow = !m_overflow.empty() && m_overflow.back().get() == p;
+    auto* const header = reinterpret_cast<OutputHeader*>(p + header_size - sizeof(OutputHeader));
+    new (header) OutputHeader{this, in_overflow ? p : m_block.get()};
+    return p + header_size;
+}
+
+evmc_result FrameArena::lease_output(evmc_status_code status, int64_t gas_left,
+    int64_t gas_refund, const uint8_t* output, size_t output_size) noexcept
+{
+    assert(m_lease == nullptr);
+    evmc_result result{};
+    result.status_code = status;
+    result.gas_left = gas_left;
+    result.gas_refund = gas_refund;
+    result.output_data = output;
+    result.output_size = output_size;
+    m_lease = reinterpret_cast<OutputHeader*>(const_cast<uint8_t*>(output)) - 1;
+    result.release = release_output;
+    return result;
+}
+
+void FrameArena::release_output(const evmc_result* result) noexcept
+{
+    auto* const header =
+        reinterpret_cast<OutputHeader*>(const_cast<uint8_t*>(result->output_data)) - 1;
+    if (header->arena != nullptr)
+        header->arena->m_lease = nullptr;  // The buffer is freed by the arena reset.
+    else
+        delete[] header->block;
+}
+}  // namespace evmone
@@ -5,10 +5,19 @@
 
 #include <evmc/evmc.hpp>
 #include <intx/intx.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
+#if defined(_WIN32) || UINTPTR_MAX <= 0xffffffff
+#define EVMONE_MAPPED_MEMORY_SUPPORTED 0
+#else
+#define EVMONE_MAPPED_MEMORY_SUPPORTED 1
+#endif
+
 namespace evmone
 {
 namespace advanced
@@ -57,18 +66,251 @@ class StackSpace
 
     /// The storage allocated for maximum possible number of items.
     /// Items are aligned to 256 bits for better packing in cache lines.
+    /// Null if the external storage is used.
     std::unique_ptr<uint256, Deleter> m_stack_space;
 
+    /// The storage of the stack items: the owned allocation or the external storage.
+    uint256* m_items = nullptr;
+
 public:
     /// The maximum number of EVM stack items.
     static constexpr auto limit = 1024;
 
-    StackSpace() noexcept : m_stack_space{allocate()} {}
+    StackSpace() noexcept : m_stack_space{allocate()}, m_items{m_stack_space.get()} {}
+
+    /// Uses the external storage for the maximum possible number of items,
+    /// e.g. the frame of the StackArena. The storage must outlive the StackSpace.
+    explicit StackSpace(uint256* items) noexcept : m_items{items} {}
+
+    /// Returns true if the external storage is used.
+    [[nodiscard]] bool external() const noexcept { return m_stack_space == nullptr; }
 
     /// Returns the pointer to the "bottom", i.e. below the stack space.
-    [[nodiscard, clang::no_sanitize("bounds")]] uint256* bottom() noexcept
+    [[nodiscard, clang::no_sanitize("bounds")]] uint256* bottom() noexcept { return m_items - 1; }
+};
+
+/// The EOF return stack of the CALLF return addresses.
+///
+/// The storage for the maximum number of items is allocated on the first push and kept
+/// when the ExecutionState is reused, so the calls never reallocate.
+class ReturnStack
+{
+    std::unique_ptr<const uint8_t*[]> m_items;
+    size_t m_size = 0;
+
+public:
+    /// The maximum number of return addresses.
+    static constexpr size_t limit = 1024;
+
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+    [[nodiscard]] bool full() const noexcept { return m_size == limit; }
+
+    /// Pushes the return address. The stack must not be full.
+    void push(const uint8_t* return_address) noexcept
+    {
+        if (INTX_UNLIKELY(m_items == nullptr))
+            m_items.reset(new const uint8_t*[limit]);
+        m_items[m_size++] = return_address;
+    }
+
+    /// Pops the return address. The stack must not be empty.
+    const uint8_t* pop() noexcept { return m_items[--m_size]; }
+
+    void clear() noexcept { m_size = 0; }
+};
+
+/// The output of the most recent call made by the frame (see RETURNDATA*).
+///
+/// The result of the call is kept as returned by the host so that the output buffer
+/// of the callee is read in place and released on the next call or when the frame ends.
+class ReturnData
+{
+    evmc::Result m_result;
+
+public:
+    /// Takes over the result of the call.
+    void assign(evmc::Result&& result) noexcept { m_result = std::move(result); }
+
+    /// Releases the result of the call.
+    void clear() noexcept { m_result = evmc::Result{}; }
+
+    [[nodiscard]] size_t size() const noexcept { return m_result.output_size; }
+
+    [[nodiscard]] bool empty() const noexcept { return m_result.output_size == 0; }
+
+    [[nodiscard]] const uint8_t* data() const noexcept { return m_result.output_data; }
+
+    const uint8_t& operator[](size_t index) const noexcept { return m_result.output_data[index]; }
+
+    operator bytes_view() const noexcept { return {data(), size()}; }
+};
+
+class ModArithCache;
+
+/// The deleter of the ModArithCache defined along with the cache (see MULMOD).
+struct EVMC_EXPORT ModArithCacheDeleter
+{
+    void operator()(ModArithCache* p) const noexcept;
+};
+
+/// The direct-mapped cache of the storage slots of the executing account.
+///
+/// The entry keeps the current value of the slot accessed in the current call frame so that
+/// the repeated SLOADs do not query the host. The cached slot is also known to be warm
+/// (EIP-2929) because its access has already been reported to the host. The SSTOREs still
+/// go to the host and update the cached value. The cache must be invalidated when
+/// the storage may be modified outside of the frame, i.e. on any outgoing call.
+class StorageCache
+{
+public:
+    /// The number of entries.
+    static constexpr size_t num_entries = 64;
+
+private:
+    struct Entry
+    {
+        uint256 key;
+        uint256 value;
+        uint64_t generation = 0;  ///< The entry is valid if equal to the cache generation.
+    };
+
+    /// The entries. Null if the cache is disabled.
+    std::unique_ptr<Entry[]> m_entries;
+
+    /// The current generation. The entries of other generations are invalid.
+    uint64_t m_generation = 1;
+
+    static size_t index(const uint256& key) noexcept
+    {
+        return static_cast<size_t>(key[0] ^ key[3]) % num_entries;
+    }
+
+public:
+    /// Allocates the entries. The disabled cache never finds any slot.
+    void enable() noexcept
+    {
+        if (m_entries == nullptr)
+            m_entries.reset(new Entry[num_entries]{});
+    }
+
+    /// Releases the entries.
+    void disable() noexcept { m_entries.reset(); }
+
+    [[nodiscard]] bool enabled() const noexcept { return m_entries != nullptr; }
+
+    /// Returns the cached current value of the slot or null if the slot is not cached.
+    [[nodiscard]] const uint256* find(const uint256& key) const noexcept
+    {
+        if (m_entries == nullptr)
+            return nullptr;
+        const auto& e = m_entries[index(key)];
+        return (e.generation == m_generation && e.key == key) ? &e.value : nullptr;
+    }
+
+    /// Caches the current value of the slot replacing the entry of the same index.
+    void put(const uint256& key, const uint256& value) noexcept
+    {
+        if (m_entries != nullptr)
+            m_entries[index(key)] = {key, value, m_generation};
+    }
+
+    /// Invalidates all entries.
+    void invalidate() noexcept { ++m_generation; }
+};
+
+/// The bump allocator of the buffers of a call frame, e.g. the output returned to the caller.
+///
+/// The arena of the ExecutionState of a call depth is reset when the state is reused
+/// by the next frame of the depth. The allocations are served from the main block.
+/// The ones not fitting in it get separate overflow blocks which are merged into the main block
+/// on the reset, so after the warm-up the frames of the depth do not allocate.
+///
+/// The output buffer can be leased to the result of the frame (see lease_output()).
+/// The result release returns the buffer to the arena. If the arena is reset or destroyed
+/// before the release, the block with the output is handed over to the result.
+class EVMC_EXPORT FrameArena
+{
+    /// The header of the output buffer placed before the output.
+    struct OutputHeader
+    {
+        FrameArena* arena;  ///< The arena owning the block or null if owned by the result.
+        uint8_t* block;     ///< The block containing the output buffer.
+    };
+
+    /// The alignment of the allocations.
+    static constexpr size_t alignment = alignof(std::max_align_t);
+
+    /// The minimal size of the main block.
+    static constexpr size_t min_block_size = 4 * 1024;
+
+    std::unique_ptr<uint8_t[]> m_block;  ///< The main block.
+    size_t m_block_size = 0;
+    size_t m_used = 0;  ///< The size of the allocated prefix of the main block.
+
+    /// The blocks allocated when the main block was exhausted.
+    std::vector<std::unique_ptr<uint8_t[]>> m_overflow;
+    size_t m_overflow_size = 0;
+
+    /// The header of the output leased to the unreleased result. Null if not leased.
+    OutputHeader* m_lease = nullptr;
+
+    static constexpr size_t align(size_t size) noexcept
+    {
+        return (size + (alignment - 1)) & ~(alignment - 1);
+    }
+
+    /// Allocates the block when the main block is exhausted.
+    uint8_t* allocate_slow(size_t size) noexcept;
+
+    /// Hands over the block of the leased output to the result.
+    void detach_lease() noexcept;
+
+    /// Replaces the main block and the overflow blocks with the main block of the total size.
+    void merge_blocks() noexcept;
+
+    /// The release of the result with the leased output.
+    static void release_output(const evmc_result* result) noexcept;
+
+public:
+    FrameArena() noexcept = default;
+    FrameArena(FrameArena&& other) noexcept;
+    FrameArena& operator=(FrameArena&& other) noexcept;
+    ~FrameArena();
+
+    /// Allocates the buffer of the positive size valid until the reset.
+    [[nodiscard]] uint8_t* allocate(size_t size) noexcept
+    {
+        const auto n = align(size);
+        if (n > m_block_size - m_used) [[unlikely]]
+            return allocate_slow(n);
+        auto* const p = &m_block[m_used];
+        m_used += n;
+        return p;
+    }
+
+    /// Allocates the output buffer to be leased with lease_output().
+    [[nodiscard]] uint8_t* allocate_output(size_t size) noexcept;
+
+    /// Makes the result with the output buffer from allocate_output(). The output stays valid
+    /// until the result is released. A single output can be leased at a time.
+    [[nodiscard]] evmc_result lease_output(evmc_status_code status, int64_t gas_left,
+        int64_t gas_refund, const uint8_t* output, size_t output_size) noexcept;
+
+    /// Is the output leased to the unreleased result?
+    [[nodiscard]] bool leased() const noexcept { return m_lease != nullptr; }
+
+    /// The total size of the blocks.
+    [[nodiscard]] size_t capacity() const noexcept { return m_block_size + m_overflow_size; }
+
+    /// Frees all allocations except the leased output.
+    void reset() noexcept
     {
-        return m_stack_space.get() - 1;
+        if (m_lease != nullptr) [[unlikely]]
+            detach_lease();
+        if (!m_overflow.empty() || (m_block == nullptr && m_block_size != 0)) [[unlikely]]
+            merge_blocks();
+        m_used = 0;
     }
 };
 
@@ -77,18 +319,35 @@ public:
 ///
 /// The implementations uses initial allocation of 4k and then grows capacity with 2x factor.
 /// Some benchmarks have been done to confirm 4k is ok-ish value.
+///
+/// Alternatively, in the mapped mode (see reserve_mapping()) the virtual memory range
+/// of mapped_capacity is reserved once and the growth within it only bumps the size:
+/// the untouched pages are provided by the OS filled with zeros. The growth above
+/// the reservation moves the memory to the heap allocation.
 class Memory
 {
     /// The size of allocation "page".
     static constexpr size_t page_size = 4 * 1024;
 
-    struct FreeDeleter
+    /// The size of the used memory prefix kept by clear() in the mapped mode.
+    /// The pages above are returned to the OS.
+    static constexpr size_t mapped_clear_threshold = 64 * 1024;
+
+    struct Deleter
     {
-        void operator()(uint8_t* p) const noexcept { std::free(p); }
+        bool mapped = false;  ///< Is the memory the reserved mapping or allocated with malloc?
+
+        void operator()(uint8_t* p) const noexcept
+        {
+            if (mapped)
+                unmap(p);
+            else
+                std::free(p);
+        }
     };
 
     /// Owned pointer to allocated memory.
-    std::unique_ptr<uint8_t[], FreeDeleter> m_data;
+    std::unique_ptr<uint8_t[], Deleter> m_data;
 
     /// The "virtual" size of the memory.
     size_t m_size = 0;
@@ -96,19 +355,90 @@ class Memory
     /// The size of allocated memory. The initialization value is the initial capacity.
     size_t m_capacity = page_size;
 
+    /// The size of the memory prefix which may contain non-zero bytes.
+    /// Above it the memory is known to be zero and does not have to be cleared by grow().
+    size_t m_dirty_size = 0;
+
     [[noreturn, gnu::cold]] static void handle_out_of_memory() noexcept { std::terminate(); }
 
+    /// Reserves the mapping of the mapped_capacity size. Returns null if not supported.
+    EVMC_EXPORT static uint8_t* map() noexcept;
+
+    /// Releases the mapping.
+    EVMC_EXPORT static void unmap(uint8_t* p) noexcept;
+
+    /// Replaces the pages of the mapping with the zero pages.
+    /// The begin must be aligned to mapped_clear_threshold. Returns false on failure.
+    EVMC_EXPORT static bool discard(uint8_t* begin, size_t size) noexcept;
+
     void allocate_capacity() noexcept
     {
         m_data.reset(static_cast<uint8_t*>(std::realloc(m_data.release(), m_capacity)));
         if (!m_data) [[unlikely]]
             handle_out_of_memory();
+        m_dirty_size = m_capacity;  // The contents of the new allocation are unspecified.
+    }
+
+    /// Moves the used memory from the mapping to the heap allocation of the m_capacity size
+    /// and leaves the mapped mode.
+    [[gnu::cold]] void move_mapping_to_heap() noexcept
+    {
+        auto* const p = static_cast<uint8_t*>(std::malloc(m_capacity));
+        if (p == nullptr) [[unlikely]]
+            handle_out_of_memory();
+        std::memcpy(p, m_data.get(), m_size);
+        m_data.reset(p);  // Unmaps the reservation.
+        m_data.get_deleter().mapped = false;
+        m_dirty_size = m_capacity;
     }
 
 public:
+    /// The size of the virtual memory range reserved in the mapped mode.
+    /// The memory of this size costs above 2^34 gas, so it is not reachable within
+    /// realistic gas limits, while the reservation of every execution state stays small.
+    static constexpr uint64_t mapped_capacity = uint64_t{128} << 20;
+
     /// Creates Memory object with initial capacity allocation.
     Memory() noexcept { allocate_capacity(); }
 
+    /// Switches the memory to the mapped mode.
+    ///
+    /// The contents are discarded. Returns false if not supported or the reservation failed;
+    /// the memory stays unchanged then.
+    bool reserve_mapping() noexcept
+    {
+        if (is_mapped())
+            return true;
+
+        auto* const p = map();
+        if (p == nullptr)
+            return false;
+
+        m_data.reset(p);
+        m_data.get_deleter().mapped = true;
+        m_size = 0;
+        m_capacity = static_cast<size_t>(mapped_capacity);
+        m_dirty_size = 0;
+        return true;
+    }
+
+    /// Switches the memory back to the default mode with the initial capacity allocation.
+    ///
+    /// The contents are discarded.
+    void release_mapping() noexcept
+    {
+        if (!is_mapped())
+            return;
+
+        m_data.reset();  // Unmaps the reservation.
+        m_data.get_deleter().mapped = false;
+        m_size = 0;
+        m_capacity = page_size;
+        allocate_capacity();
+    }
+
+    [[nodiscard]] bool is_mapped() const noexcept { return m_data.get_deleter().mapped; }
+
     uint8_t& operator[](size_t index) noexcept { return m_data[index]; }
 
     [[nodiscard]] const uint8_t* data() const noexcept { return m_data.get(); }
@@ -135,14 +465,30 @@ public:
                 m_capacity = ((new_size + (page_size - 1)) / page_size) * page_size;
             }
 
-            allocate_capacity();
+            if (is_mapped()) [[unlikely]]
+                move_mapping_to_heap();
+            else
+                allocate_capacity();
         }
-        std::memset(&m_data[m_size], 0, new_size - m_size);
+
+        // Only the previously used part must be cleared.
+        if (m_dirty_size > m_size)
+            std::memset(&m_data[m_size], 0, std::min(new_size, m_dirty_size) - m_size);
         m_size = new_size;
+        m_dirty_size = std::max(m_dirty_size, new_size);
     }
 
     /// Virtually clears the memory by setting its size to 0. The capacity stays unchanged.
-    void clear() noexcept { m_size = 0; }
+    /// In the mapped mode the used pages above the mapped_clear_threshold are returned to the OS.
+    void clear() noexcept
+    {
+        m_size = 0;
+        if (is_mapped() && m_dirty_size > mapped_clear_threshold) [[unlikely]]
+        {
+            if (discard(&m_data[mapped_clear_threshold], m_dirty_size - mapped_clear_threshold))
+                m_dirty_size = mapped_clear_threshold;
+        }
+    }
 };
 
 
@@ -156,7 +502,7 @@ public:
     const evmc_message* msg = nullptr;
     evmc::HostContext host;
     evmc_revision rev = {};
-    bytes return_data;
+    ReturnData return_data;
 
     /// Reference to original EVM code container.
     /// For legacy code this is a reference to entire original code.
@@ -168,7 +514,8 @@ public:
     size_t output_size = 0;
 
     /// Container to be deployed returned from RETURNCONTRACT, used only inside EOFCREATE execution.
-    std::optional<bytes> deploy_container;
+    /// It is the output buffer of the frame allocated in the arena.
+    std::optional<bytes_view> deploy_container;
 
 private:
     evmc_tx_context m_tx = {};
@@ -182,7 +529,17 @@ public:
         const advanced::AdvancedCodeAnalysis* advanced;
     } analysis{};
 
-    std::vector<const uint8_t*> call_stack;
+    ReturnStack call_stack;
+
+    /// The cache of the storage slots of the recipient accessed in this frame.
+    StorageCache storage_cache;
+
+    /// The arena of the frame buffers.
+    FrameArena arena;
+
+    /// The cache of the modular arithmetic of MULMOD by the modulus. Allocated on the first use
+    /// and kept when the ExecutionState is reused because it does not depend on the state.
+    std::unique_ptr<ModArithCache, ModArithCacheDeleter> mod_arith_cache;
 
     /// Stack space allocation.
     ///
@@ -191,6 +548,9 @@ public:
 
     ExecutionState() noexcept = default;
 
+    /// Creates the ExecutionState using the external storage for the stack space.
+    explicit ExecutionState(uint256* stack_items) noexcept : stack_space{stack_items} {}
+
     ExecutionState(const evmc_message& message, evmc_revision revision,
         const evmc_host_interface& host_interface, evmc_host_context* host_ctx,
         bytes_view _code) noexcept
@@ -214,7 +574,9 @@ public:
         output_size = 0;
         deploy_container = {};
         m_tx = {};
-        call_stack = {};
+        call_stack.clear();
+        storage_cache.invalidate();
+        arena.reset();
     }
 
     [[nodiscard]] bool in_static_mode() const { return (msg->flags & EVMC_STATIC) != 0; }
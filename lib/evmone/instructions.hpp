@@ -152,6 +152,28 @@ inline TermResult stop_impl(
 inline constexpr auto stop = stop_impl<EVMC_SUCCESS>;
 inline constexpr auto invalid = stop_impl<EVMC_INVALID_INSTRUCTION>;
 
+/// Checks if both values fit in a single 64-bit word.
+///
+/// Such values are common (counters, offsets, lengths, etc.) so the arithmetic instructions
+/// expensive for the full 256-bit values use the native instructions for them.
+inline bool fit_word(const uint256& x, const uint256& y) noexcept
+{
+    return (x[1] | x[2] | x[3] | y[1] | y[2] | y[3]) == 0;
+}
+
+/// Multiplies y by x in place. Uses the single native multiplication if both fit in a word.
+inline void mul_assign(uint256& y, const uint256& x) noexcept
+{
+    if (fit_word(x, y))
+    {
+        const auto p = intx::umul(x[0], y[0]);
+        y[0] = p[0];
+        y[1] = p[1];  // The higher words are zero.
+    }
+    else
+        y *= x;
+}
+
 inline void add(StackTop stack) noexcept
 {
     stack.top() += stack.pop();
@@ -159,7 +181,8 @@ inline void add(StackTop stack) noexcept
 
 inline void mul(StackTop stack) noexcept
 {
-    stack.top() *= stack.pop();
+    const auto& x = stack.pop();
+    mul_assign(stack.top(), x);
 }
 
 inline void sub(StackTop stack) noexcept
@@ -169,26 +192,42 @@ inline void sub(StackTop stack) noexcept
 
 inline void div(StackTop stack) noexcept
 {
+    const auto& x = stack[0];
     auto& v = stack[1];
-    v = v != 0 ? stack[0] / v : 0;
+    if (fit_word(x, v))
+        v[0] = v[0] != 0 ? x[0] / v[0] : 0;
+    else
+        v = v != 0 ? x / v : 0;
 }
 
 inline void sdiv(StackTop stack) noexcept
 {
+    const auto& x = stack[0];
     auto& v = stack[1];
-    v = v != 0 ? intx::sdivrem(stack[0], v).quot : 0;
+    if (fit_word(x, v))  // The values fitting in a word are non-negative.
+        v[0] = v[0] != 0 ? x[0] / v[0] : 0;
+    else
+        v = v != 0 ? intx::sdivrem(x, v).quot : 0;
 }
 
 inline void mod(StackTop stack) noexcept
 {
+    const auto& x = stack[0];
     auto& v = stack[1];
-    v = v != 0 ? stack[0] % v : 0;
+    if (fit_word(x, v))
+        v[0] = v[0] != 0 ? x[0] % v[0] : 0;
+    else
+        v = v != 0 ? x % v : 0;
 }
 
 inline void smod(StackTop stack) noexcept
 {
+    const auto& x = stack[0];
     auto& v = stack[1];
-    v = v != 0 ? intx::sdivrem(stack[0], v).rem : 0;
+    if (fit_word(x, v))  // The values fitting in a word are non-negative.
+        v[0] = v[0] != 0 ? x[0] % v[0] : 0;
+    else
+        v = v != 0 ? intx::sdivrem(x, v).rem : 0;
 }
 
 inline void addmod(StackTop stack) noexcept
@@ -199,12 +238,27 @@ inline void addmod(StackTop stack) noexcept
     m = m != 0 ? intx::addmod(x, y, m) : 0;
 }
 
-inline void mulmod(StackTop stack) noexcept
+/// MULMOD uses the cached Montgomery arithmetic of the repeated odd moduli
+/// (see ExecutionState::mod_arith_cache).
+Result mulmod(StackTop stack, int64_t gas_left, ExecutionState& state) noexcept;
+
+/// Computes the base to the power of the exponent fitting in a word.
+///
+/// Unlike intx::exp() this shifts only the single word exponent, skips the final squaring
+/// and multiplies the values fitting in a word natively, e.g. 10**18 is computed with
+/// the native multiplications only.
+inline uint256 exp_by_word(uint256 base, uint64_t exponent) noexcept
 {
-    const auto& x = stack[0];
-    const auto& y = stack[1];
-    auto& m = stack[2];
-    m = m != 0 ? intx::mulmod(x, y, m) : 0;
+    uint256 result = 1;
+    while (true)
+    {
+        if ((exponent & 1) != 0)
+            mul_assign(result, base);
+        exponent >>= 1;
+        if (exponent == 0)
+            return result;
+        mul_assign(base, base);
+    }
 }
 
 inline Result exp(StackTop stack, int64_t gas_left, ExecutionState& state) noexcept
@@ -219,7 +273,12 @@ inline Result exp(StackTop stack, int64_t gas_left, ExecutionState& state) noexc
     if ((gas_left -= additional_cost) < 0)
         return {EVMC_OUT_OF_GAS, gas_left};
 
-    exponent = intx::exp(base, exponent);
+    if (base == 2)  // Common for the bit masks.
+        exponent = uint256{1} << exponent;
+    else if ((exponent[1] | exponent[2] | exponent[3]) == 0)
+        exponent = exp_by_word(base, exponent[0]);
+    else
+        exponent = intx::exp(base, exponent);
     return {EVMC_SUCCESS, gas_left};
 }
 
@@ -1099,50 +1158,40 @@ Result eofcreate(
 inline code_iterator callf(StackTop stack, ExecutionState& state, code_iterator pos) noexcept
 {
     const auto index = read_uint16_be(&pos[1]);
-    const auto& header = state.analysis.baseline->eof_header();
+    const auto& callee = state.analysis.baseline->eof_code_section(index);
     const auto stack_size = &stack.top() - state.stack_space.bottom();
-    const auto callee_type = header.get_type(state.original_code, index);
-    const auto callee_required_stack_size = callee_type.max_stack_height - callee_type.inputs;
-    if (stack_size + callee_required_stack_size > StackSpace::limit)
+    if (stack_size + callee.max_stack_increase > StackSpace::limit)
     {
         state.status = EVMC_STACK_OVERFLOW;
         return nullptr;
     }
 
-    if (state.call_stack.size() >= StackSpace::limit)
+    if (state.call_stack.full())
     {
         // TODO: Add different error code.
         state.status = EVMC_STACK_OVERFLOW;
         return nullptr;
     }
-    state.call_stack.push_back(pos + 3);
-
-    const auto offset = header.code_offsets[index] - header.code_offsets[0];
-    return state.analysis.baseline->executable_code().data() + offset;
+    state.call_stack.push(pos + 3);
+    return callee.code;
 }
 
 inline code_iterator retf(StackTop /*stack*/, ExecutionState& state, code_iterator /*pos*/) noexcept
 {
-    const auto p = state.call_stack.back();
-    state.call_stack.pop_back();
-    return p;
+    return state.call_stack.pop();
 }
 
 inline code_iterator jumpf(StackTop stack, ExecutionState& state, code_iterator pos) noexcept
 {
     const auto index = read_uint16_be(&pos[1]);
-    const auto& header = state.analysis.baseline->eof_header();
+    const auto& callee = state.analysis.baseline->eof_code_section(index);
     const auto stack_size = &stack.top() - state.stack_space.bottom();
-    const auto callee_type = header.get_type(state.original_code, index);
-    const auto callee_required_stack_size = callee_type.max_stack_height - callee_type.inputs;
-    if (stack_size + callee_required_stack_size > StackSpace::limit)
+    if (stack_size + callee.max_stack_increase > StackSpace::limit)
     {
         state.status = EVMC_STACK_OVERFLOW;
         return nullptr;
     }
-
-    const auto offset = header.code_offsets[index] - header.code_offsets[0];
-    return state.analysis.baseline->executable_code().data() + offset;
+    return callee.code;
 }
 
 template <evmc_status_code StatusCode>
@@ -1172,15 +1221,20 @@ inline TermResult returncontract(
         return {EVMC_OUT_OF_GAS, gas_left};
 
     const auto deploy_container_index = size_t{pos[1]};
-    bytes deploy_container{state.analysis.baseline->eof_header().get_container(
-        state.original_code, deploy_container_index)};
+    const auto container = state.analysis.baseline->eof_header().get_container(
+        state.original_code, deploy_container_index);
+    const bytes_view aux_data{
+        &state.memory[static_cast<size_t>(offset)], static_cast<size_t>(size)};
+
+    // The deploy container is the output of the frame so it is built in the output buffer.
+    const auto deploy_container_size = container.size() + aux_data.size();
+    auto* const deploy_container = state.arena.allocate_output(deploy_container_size);
 
     // Append (offset, size) to data section
-    if (!append_data_section(deploy_container,
-            {&state.memory[static_cast<size_t>(offset)], static_cast<size_t>(size)}))
+    if (!append_data_section(deploy_container, container, aux_data))
         return {EVMC_OUT_OF_GAS, gas_left};
 
-    state.deploy_container = std::move(deploy_container);
+    state.deploy_container = bytes_view{deploy_container, deploy_container_size};
 
     return {EVMC_SUCCESS, gas_left};
 }
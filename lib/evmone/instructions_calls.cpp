@@ -168,8 +168,8 @@ Result call_impl(StackTop stack, int64_t gas_left, ExecutionState& state) noexce
     if (has_value && intx::be::load<uint256>(state.host.get_balance(state.msg->recipient)) < value)
         return {EVMC_SUCCESS, gas_left};  // "Light" failure.
 
-    const auto result = state.host.call(msg);
-    state.return_data.assign(result.output_data, result.output_size);
+    state.storage_cache.invalidate();  // The callee may modify the storage.
+    auto result = state.host.call(msg);
     stack.top() = result.status_code == EVMC_SUCCESS;
 
     if (const auto copy_size = std::min(output_size, result.output_size); copy_size > 0)
@@ -178,6 +178,7 @@ Result call_impl(StackTop stack, int64_t gas_left, ExecutionState& state) noexce
     const auto gas_used = msg.gas - result.gas_left;
     gas_left -= gas_used;
     state.gas_refund += result.gas_refund;
+    state.return_data.assign(std::move(result));
     return {EVMC_SUCCESS, gas_left};
 }
 
@@ -288,8 +289,8 @@ Result extcall_impl(StackTop stack, int64_t gas_left, ExecutionState& state) noe
         }
     }
 
-    const auto result = state.host.call(msg);
-    state.return_data.assign(result.output_data, result.output_size);
+    state.storage_cache.invalidate();  // The callee may modify the storage.
+    auto result = state.host.call(msg);
     if (result.status_code == EVMC_SUCCESS)
         stack.top() = EXTCALL_SUCCESS;
     else if (result.status_code == EVMC_REVERT)
@@ -300,6 +301,7 @@ Result extcall_impl(StackTop stack, int64_t gas_left, ExecutionState& state) noe
     const auto gas_used = msg.gas - result.gas_left;
     gas_left -= gas_used;
     state.gas_refund += result.gas_refund;
+    state.return_data.assign(std::move(result));
     return {EVMC_SUCCESS, gas_left};
 }
 
@@ -370,13 +372,14 @@ Result create_impl(StackTop stack, int64_t gas_left, ExecutionState& state) noex
     msg.create2_salt = intx::be::store<evmc::bytes32>(salt);
     msg.value = intx::be::store<evmc::uint256be>(endowment);
 
-    const auto result = state.host.call(msg);
+    state.storage_cache.invalidate();  // The callee may modify the storage.
+    auto result = state.host.call(msg);
     gas_left -= msg.gas - result.gas_left;
     state.gas_refund += result.gas_refund;
 
-    state.return_data.assign(result.output_data, result.output_size);
     if (result.status_code == EVMC_SUCCESS)
         stack.top() = intx::be::load<uint256>(result.create_address);
+    state.return_data.assign(std::move(result));
 
     return {EVMC_SUCCESS, gas_left};
 }
@@ -437,13 +440,14 @@ Result eofcreate(
     msg.code = initcontainer.data();
     msg.code_size = initcontainer.size();
 
-    const auto result = state.host.call(msg);
+    state.storage_cache.invalidate();  // The callee may modify the storage.
+    auto result = state.host.call(msg);
     gas_left -= msg.gas - result.gas_left;
     state.gas_refund += result.gas_refund;
 
-    state.return_data.assign(result.output_data, result.output_size);
     if (result.status_code == EVMC_SUCCESS)
         stack.top() = intx::be::load<uint256>(result.create_address);
+    state.return_data.assign(std::move(result));
 
     return {EVMC_SUCCESS, gas_left};
 }
@@ -0,0 +1,88 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "instructions.hpp"
+#include <evmmax/evmmax.hpp>
+#include <array>
+#include <optional>
+
+namespace evmone
+{
+/// The cache of the Montgomery modular arithmetic by the MULMOD modulus.
+///
+/// Creating the ModArith costs about as much as a single MULMOD by division so the modulus
+/// is cached when it misses the cache the second time in a row. This way the code repeatedly
+/// using the same modulus, e.g. the verifiers of the elliptic curve based proofs, gets
+/// the cached ModArith after the first MULMOD and the code using varying moduli pays only
+/// for the comparisons.
+class ModArithCache
+{
+public:
+    /// The number of cached moduli.
+    static constexpr size_t num_entries = 2;
+
+private:
+    std::array<std::optional<evmmax::ModArith<uint256>>, num_entries> m_entries;
+
+    /// The last modulus which missed the cache.
+    uint256 m_candidate;
+
+    /// The index of the entry to be replaced next.
+    size_t m_next = 0;
+
+public:
+    /// Returns the modular arithmetic of the odd modulus or null if the modulus is not cached.
+    const evmmax::ModArith<uint256>* get(const uint256& mod) noexcept
+    {
+        for (const auto& e : m_entries)
+        {
+            if (e.has_value() && e->mod == mod)
+                return &*e;
+        }
+
+        if (mod != m_candidate)
+        {
+            m_candidate = mod;
+            return nullptr;
+        }
+
+        auto& e = m_entries[m_next];
+        m_next = (m_next + 1) % num_entries;
+        return &e.emplace(mod);
+    }
+};
+
+void ModArithCacheDeleter::operator()(ModArithCache* p) const noexcept
+{
+    delete p;
+}
+
+namespace instr::core
+{
+Result mulmod(StackTop stack, int64_t gas_left, ExecutionState& state) noexcept
+{
+    const auto& x = stack[0];
+    const auto& y = stack[1];
+    auto& m = stack[2];
+
+    // The Montgomery multiplication requires the odd modulus.
+    if ((m[0] & 1) != 0)
+    {
+        if (state.mod_arith_cache == nullptr)
+            state.mod_arith_cache.reset(new ModArithCache{});
+
+        if (const auto* const arith = state.mod_arith_cache->get(m); arith != nullptr)
+        {
+            // The x in the Montgomery form xR is less than the modulus so it can be multiplied
+            // by any y < 2²⁵⁶ and the result is xR⋅y⋅R⁻¹ = xy in the normal form.
+            m = arith->mul(arith->to_mont(x), y);
+            return {EVMC_SUCCESS, gas_left};
+        }
+    }
+
+    m = m != 0 ? intx::mulmod(x, y, m) : 0;
+    return {EVMC_SUCCESS, gas_left};
+}
+}  // namespace instr::core
+}  // namespace evmone
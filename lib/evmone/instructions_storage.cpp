@@ -96,6 +96,13 @@ constexpr auto sstore_costs = []() noexcept {
 Result sload(StackTop stack, int64_t gas_left, ExecutionState& state) noexcept
 {
     auto& x = stack.top();
+    if (const auto* const cached = state.storage_cache.find(x); cached != nullptr)
+    {
+        // The cached slot is warm so the cost from the cost table is final.
+        x = *cached;
+        return {EVMC_SUCCESS, gas_left};
+    }
+
     const auto key = intx::be::store<evmc::bytes32>(x);
 
     if (state.rev >= EVMC_BERLIN &&
@@ -109,7 +116,9 @@ Result sload(StackTop stack, int64_t gas_left, ExecutionState& state) noexcept
             return {EVMC_OUT_OF_GAS, gas_left};
     }
 
-    x = intx::be::load<uint256>(state.host.get_storage(state.msg->recipient, key));
+    const auto value = intx::be::load<uint256>(state.host.get_storage(state.msg->recipient, key));
+    state.storage_cache.put(x, value);
+    x = value;
 
     return {EVMC_SUCCESS, gas_left};
 }
@@ -122,15 +131,19 @@ Result sstore(StackTop stack, int64_t gas_left, ExecutionState& state) noexcept
     if (state.rev >= EVMC_ISTANBUL && gas_left <= 2300)
         return {EVMC_OUT_OF_GAS, gas_left};
 
-    const auto key = intx::be::store<evmc::bytes32>(stack.pop());
-    const auto value = intx::be::store<evmc::bytes32>(stack.pop());
+    const auto& slot = stack.pop();
+    const auto& new_value = stack.pop();
+    const auto key = intx::be::store<evmc::bytes32>(slot);
+    const auto value = intx::be::store<evmc::bytes32>(new_value);
 
+    // The slot in the storage cache is warm.
     const auto gas_cost_cold =
-        (state.rev >= EVMC_BERLIN &&
+        (state.rev >= EVMC_BERLIN && state.storage_cache.find(slot) == nullptr &&
             state.host.access_storage(state.msg->recipient, key) == EVMC_ACCESS_COLD) ?
             instr::cold_sload_cost :
             0;
     const auto status = state.host.set_storage(state.msg->recipient, key, value);
+    state.storage_cache.put(slot, new_value);
 
     const auto [gas_cost_warm, gas_refund] = sstore_costs[state.rev][status];
     const auto gas_cost = gas_cost_warm + gas_cost_cold;
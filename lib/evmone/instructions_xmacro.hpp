@@ -9,15 +9,19 @@
 /// The default macro for ON_OPCODE_UNDEFINED. Empty implementation to ignore undefined opcodes.
 #define ON_OPCODE_UNDEFINED_DEFAULT(OPCODE)
 
+/// The default macro for ON_OPCODE_FUSED. It redirects to ON_OPCODE_UNDEFINED.
+#define ON_OPCODE_FUSED_DEFAULT(OPCODE, NAME) ON_OPCODE_UNDEFINED(OPCODE)
+
 
 #define ON_OPCODE_IDENTIFIER ON_OPCODE_IDENTIFIER_DEFAULT
 #define ON_OPCODE_UNDEFINED ON_OPCODE_UNDEFINED_DEFAULT
+#define ON_OPCODE_FUSED ON_OPCODE_FUSED_DEFAULT
 
 
 /// The "X Macro" for opcodes and their matching identifiers.
 ///
 /// The MAP_OPCODES is an extended variant of X Macro idiom.
-/// It has 3 knobs for users.
+/// It has 4 knobs for users.
 ///
 /// 1. The ON_OPCODE(OPCODE) macro must be defined. It will receive all defined opcodes from
 ///    the evmc_opcode enum.
@@ -29,6 +33,11 @@
 ///    the pairs of all defined opcodes and their matching identifiers.
 ///    This macro is by default alias to ON_OPCODE_IDENTIFIER_DEFAULT therefore users must first
 ///    undef it and restore the alias after usage.
+/// 4. The ON_OPCODE_FUSED(OPCODE, NAME) macro may be defined to receive the undefined opcodes
+///    reserved for the Baseline superinstructions (fused instruction sequences) and their names.
+///    These never appear in the code executed without the superinstructions enabled.
+///    This macro is by default alias to ON_OPCODE_FUSED_DEFAULT which passes the opcodes
+///    to ON_OPCODE_UNDEFINED.
 ///
 /// See for more about X Macros: https://en.wikipedia.org/wiki/X_Macro.
 #define MAP_OPCODES                                           \
@@ -219,16 +228,16 @@
     ON_OPCODE_UNDEFINED(0xae)                                 \
     ON_OPCODE_UNDEFINED(0xaf)                                 \
                                                               \
-    ON_OPCODE_UNDEFINED(0xb0)                                 \
-    ON_OPCODE_UNDEFINED(0xb1)                                 \
-    ON_OPCODE_UNDEFINED(0xb2)                                 \
-    ON_OPCODE_UNDEFINED(0xb3)                                 \
-    ON_OPCODE_UNDEFINED(0xb4)                                 \
-    ON_OPCODE_UNDEFINED(0xb5)                                 \
-    ON_OPCODE_UNDEFINED(0xb6)                                 \
-    ON_OPCODE_UNDEFINED(0xb7)                                 \
-    ON_OPCODE_UNDEFINED(0xb8)                                 \
-    ON_OPCODE_UNDEFINED(0xb9)                                 \
+    ON_OPCODE_FUSED(0xb0, PUSH1_JUMP)                         \
+    ON_OPCODE_FUSED(0xb1, PUSH2_JUMP)                         \
+    ON_OPCODE_FUSED(0xb2, PUSH3_JUMP)                         \
+    ON_OPCODE_FUSED(0xb3, PUSH1_JUMPI)                        \
+    ON_OPCODE_FUSED(0xb4, PUSH2_JUMPI)                        \
+    ON_OPCODE_FUSED(0xb5, PUSH3_JUMPI)                        \
+    ON_OPCODE_FUSED(0xb6, PUSH1_ADD)                          \
+    ON_OPCODE_FUSED(0xb7, ISZERO_PUSH1_JUMPI)                 \
+    ON_OPCODE_FUSED(0xb8, ISZERO_PUSH2_JUMPI)                 \
+    ON_OPCODE_FUSED(0xb9, ISZERO_PUSH3_JUMPI)                 \
     ON_OPCODE_UNDEFINED(0xba)                                 \
     ON_OPCODE_UNDEFINED(0xbb)                                 \
     ON_OPCODE_UNDEFINED(0xbc)                                 \
@@ -236,22 +245,22 @@
     ON_OPCODE_UNDEFINED(0xbe)                                 \
     ON_OPCODE_UNDEFINED(0xbf)                                 \
                                                               \
-    ON_OPCODE_UNDEFINED(0xc0)                                 \
-    ON_OPCODE_UNDEFINED(0xc1)                                 \
-    ON_OPCODE_UNDEFINED(0xc2)                                 \
-    ON_OPCODE_UNDEFINED(0xc3)                                 \
-    ON_OPCODE_UNDEFINED(0xc4)                                 \
-    ON_OPCODE_UNDEFINED(0xc5)                                 \
-    ON_OPCODE_UNDEFINED(0xc6)                                 \
-    ON_OPCODE_UNDEFINED(0xc7)                                 \
-    ON_OPCODE_UNDEFINED(0xc8)                                 \
-    ON_OPCODE_UNDEFINED(0xc9)                                 \
-    ON_OPCODE_UNDEFINED(0xca)                                 \
-    ON_OPCODE_UNDEFINED(0xcb)                                 \
-    ON_OPCODE_UNDEFINED(0xcc)                                 \
-    ON_OPCODE_UNDEFINED(0xcd)                                 \
-    ON_OPCODE_UNDEFINED(0xce)                                 \
-    ON_OPCODE_UNDEFINED(0xcf)                                 \
+    ON_OPCODE_FUSED(0xc0, DUP1_SWAP1)                         \
+    ON_OPCODE_FUSED(0xc1, DUP1_SWAP2)                         \
+    ON_OPCODE_FUSED(0xc2, DUP1_SWAP3)                         \
+    ON_OPCODE_FUSED(0xc3, DUP1_SWAP4)                         \
+    ON_OPCODE_FUSED(0xc4, DUP2_SWAP1)                         \
+    ON_OPCODE_FUSED(0xc5, DUP2_SWAP2)                         \
+    ON_OPCODE_FUSED(0xc6, DUP2_SWAP3)                         \
+    ON_OPCODE_FUSED(0xc7, DUP2_SWAP4)                         \
+    ON_OPCODE_FUSED(0xc8, DUP3_SWAP1)                         \
+    ON_OPCODE_FUSED(0xc9, DUP3_SWAP2)                         \
+    ON_OPCODE_FUSED(0xca, DUP3_SWAP3)                         \
+    ON_OPCODE_FUSED(0xcb, DUP3_SWAP4)                         \
+    ON_OPCODE_FUSED(0xcc, DUP4_SWAP1)                         \
+    ON_OPCODE_FUSED(0xcd, DUP4_SWAP2)                         \
+    ON_OPCODE_FUSED(0xce, DUP4_SWAP3)                         \
+    ON_OPCODE_FUSED(0xcf, DUP4_SWAP4)                         \
                                                               \
     ON_OPCODE_IDENTIFIER(OP_DATALOAD, dataload)               \
     ON_OPCODE_IDENTIFIER(OP_DATALOADN, dataloadn)             \
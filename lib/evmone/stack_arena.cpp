@@ -0,0 +1,55 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stack_arena.hpp"
+
+#if EVMONE_STACK_ARENA_SUPPORTED
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace evmone
+{
+StackArena::~StackArena()
+{
+#if EVMONE_STACK_ARENA_SUPPORTED
+    if (m_region != nullptr)
+        munmap(m_region, m_region_size);
+#endif
+}
+
+bool StackArena::reserve() noexcept
+{
+#if EVMONE_STACK_ARENA_SUPPORTED
+    if (reserved())
+        return true;
+
+    const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    if (frame_size % page_size != 0)
+        return false;
+
+    // Reserve the whole region inaccessible and open the frames between the guard pages.
+    const auto frames_size = num_frames * frame_size;
+    const auto region_size = page_size + frames_size + page_size;
+    auto* const region = mmap(nullptr, region_size, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (region == MAP_FAILED)
+        return false;
+
+    auto* const frames = static_cast<uint8_t*>(region) + page_size;
+    if (mprotect(frames, frames_size, PROT_READ | PROT_WRITE) != 0)
+    {
+        munmap(region, region_size);
+        return false;
+    }
+
+    m_region = static_cast<uint8_t*>(region);
+    m_region_size = region_size;
+    m_frames = reinterpret_cast<uint256*>(frames);
+    return true;
+#else
+    return false;
+#endif
+}
+}  // namespace evmone
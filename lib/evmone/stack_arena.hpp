@@ -0,0 +1,53 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "execution_state.hpp"
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_WIN32)
+#define EVMONE_STACK_ARENA_SUPPORTED 0
+#else
+#define EVMONE_STACK_ARENA_SUPPORTED 1
+#endif
+
+namespace evmone
+{
+/// The contiguous virtual memory region of the EVM stacks of all call depths.
+///
+/// The stack of the frame at depth N is placed right after the stack of the frame at depth N-1.
+/// The region is reserved once and the pages are committed by the OS on the first access,
+/// so only the used parts of the stacks are resident. The region is surrounded
+/// by inaccessible guard pages.
+class EVMC_EXPORT StackArena
+{
+    uint8_t* m_region = nullptr;  ///< The reserved region including the guard pages.
+    size_t m_region_size = 0;
+    uint256* m_frames = nullptr;  ///< The stack of the first frame.
+
+public:
+    /// The size of the stack space of a single frame.
+    static constexpr size_t frame_size = StackSpace::limit * sizeof(uint256);
+
+    /// The number of frames: the maximum call depth 1024 plus the top-level frame.
+    static constexpr size_t num_frames = 1025;
+
+    StackArena() noexcept = default;
+    StackArena(const StackArena&) = delete;
+    StackArena& operator=(const StackArena&) = delete;
+    ~StackArena();
+
+    /// Reserves the region. Returns false if not supported or the reservation fails.
+    bool reserve() noexcept;
+
+    [[nodiscard]] bool reserved() const noexcept { return m_frames != nullptr; }
+
+    /// Returns the stack space of the frame at the call depth. The arena must be reserved.
+    [[nodiscard]] uint256* frame(size_t depth) const noexcept
+    {
+        return &m_frames[depth * StackSpace::limit];
+    }
+};
+}  // namespace evmone
@@ -9,17 +9,29 @@
 #include "advanced_execution.hpp"
 #include "baseline.hpp"
 #include <evmone/evmone.h>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <charconv>
 #include <iostream>
+#include <limits>
 
 namespace evmone
 {
 namespace
 {
+/// The counter of the VM instances for the unique VM ids.
+std::atomic<uint64_t> vm_counter{0};
+
 void destroy(evmc_vm* vm) noexcept
 {
     assert(vm != nullptr);
-    delete static_cast<VM*>(vm);
+    auto* const evmone_vm = static_cast<VM*>(vm);
+
+    // Persist the cached analyses for the next VM instances.
+    evmone_vm->get_analysis_cache().save_file();
+
+    delete evmone_vm;
 }
 
 constexpr evmc_capabilities_flagset get_capabilities(evmc_vm* /*vm*/) noexcept
@@ -43,7 +55,9 @@ evmc_set_option_result set_option(evmc_vm* c_vm, char const* c_name, char const*
 #if EVMONE_CGOTO_SUPPORTED
         if (value == "no")
         {
+            // The legacy option selects the switch dispatch.
             vm.cgoto = false;
+            vm.tailcall = false;
             return EVMC_SET_OPTION_SUCCESS;
         }
         return EVMC_SET_OPTION_INVALID_VALUE;
@@ -51,6 +65,32 @@ evmc_set_option_result set_option(evmc_vm* c_vm, char const* c_name, char const*
         return EVMC_SET_OPTION_INVALID_NAME;
 #endif
     }
+    else if (name == "dispatch")
+    {
+        if (value == "switch")
+        {
+            vm.cgoto = false;
+            vm.tailcall = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+#if EVMONE_CGOTO_SUPPORTED
+        if (value == "cgoto")
+        {
+            vm.cgoto = true;
+            vm.tailcall = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+#endif
+#if EVMONE_TAILCALL_SUPPORTED
+        if (value == "tailcall")
+        {
+            vm.cgoto = false;
+            vm.tailcall = true;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+#endif
+        return EVMC_SET_OPTION_INVALID_VALUE;
+    }
     else if (name == "trace")
     {
         vm.add_tracer(create_instruction_tracer(std::clog));
@@ -66,6 +106,152 @@ evmc_set_option_result set_option(evmc_vm* c_vm, char const* c_name, char const*
         vm.validate_eof = true;
         return EVMC_SET_OPTION_SUCCESS;
     }
+    else if (name == "superinstructions")
+    {
+        if (value == "yes")
+        {
+            vm.superinstructions = true;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        if (value == "no")
+        {
+            vm.superinstructions = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        return EVMC_SET_OPTION_INVALID_VALUE;
+    }
+    else if (name == "block_checks")
+    {
+        if (value == "yes")
+        {
+            vm.block_checks = true;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        if (value == "no")
+        {
+            vm.block_checks = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        return EVMC_SET_OPTION_INVALID_VALUE;
+    }
+    else if (name == "jit")
+    {
+#if EVMONE_JIT_SUPPORTED
+        if (value == "yes")
+        {
+            vm.jit = true;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+#endif
+        if (value == "no")
+        {
+            vm.jit = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        return EVMC_SET_OPTION_INVALID_VALUE;
+    }
+    else if (name == "concurrent")
+    {
+        if (value == "yes")
+        {
+            vm.concurrent = true;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        if (value == "no")
+        {
+            vm.concurrent = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        return EVMC_SET_OPTION_INVALID_VALUE;
+    }
+    else if (name == "stack_arena")
+    {
+#if EVMONE_STACK_ARENA_SUPPORTED
+        if (value == "yes")
+        {
+            vm.stack_arena = true;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+#endif
+        if (value == "no")
+        {
+            vm.stack_arena = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        return EVMC_SET_OPTION_INVALID_VALUE;
+    }
+    else if (name == "mapped_memory")
+    {
+#if EVMONE_MAPPED_MEMORY_SUPPORTED
+        if (value == "yes")
+        {
+            vm.mapped_memory = true;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+#endif
+        if (value == "no")
+        {
+            vm.mapped_memory = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        return EVMC_SET_OPTION_INVALID_VALUE;
+    }
+    else if (name == "storage_cache")
+    {
+        if (value == "yes")
+        {
+            vm.storage_cache = true;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        if (value == "no")
+        {
+            vm.storage_cache = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        return EVMC_SET_OPTION_INVALID_VALUE;
+    }
+    else if (name == "zero_copy_output")
+    {
+        if (value == "yes")
+        {
+            vm.zero_copy_output = true;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        if (value == "no")
+        {
+            vm.zero_copy_output = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        return EVMC_SET_OPTION_INVALID_VALUE;
+    }
+    else if (name == "analysis_cache")
+    {
+        // The value is the cache size limit in MiB. The 0 disables the cache.
+        constexpr size_t MiB = 1024 * 1024;
+        size_t max_size_mib = 0;
+        const auto value_end = value.data() + value.size();
+        if (const auto [end, ec] = std::from_chars(value.data(), value_end, max_size_mib);
+            ec != std::errc{} || end != value_end)
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        if (max_size_mib > std::numeric_limits<size_t>::max() / MiB)
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        vm.get_analysis_cache().set_max_size(max_size_mib * MiB);
+        return EVMC_SET_OPTION_SUCCESS;
+    }
+    else if (name == "analysis_cache_file")
+    {
+        // The value is the path of the persistent analysis cache file.
+        if (value.empty() || !vm.get_analysis_cache().open_file(std::string{value}))
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        return EVMC_SET_OPTION_SUCCESS;
+    }
+    else if (name == "aot")
+    {
+        // The value is the path of the shared object with the ahead-of-time compiled contracts.
+        if (value.empty() || !vm.get_aot_registry().load(c_value))
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        return EVMC_SET_OPTION_SUCCESS;
+    }
     return EVMC_SET_OPTION_INVALID_NAME;
 }
 
@@ -81,20 +267,113 @@ VM::VM() noexcept
         evmone::baseline::execute,
         evmone::get_capabilities,
         evmone::set_option,
-    }
+    },
+    m_id{++vm_counter}
 {
     m_execution_states.reserve(1025);
 }
 
+VM::ThreadStates& VM::get_thread_states() noexcept
+{
+    // The last used execution states of the thread. The VM ids are never reused
+    // so the states of a destroyed VM are never matched.
+    thread_local struct
+    {
+        uint64_t vm_id = 0;
+        ThreadStates* states = nullptr;
+    } last;
+
+    if (last.vm_id == m_id)
+        return *last.states;
+
+    const auto thread_id = std::this_thread::get_id();
+    const std::lock_guard lock{m_thread_states_mutex};
+    auto it = std::ranges::find_if(
+        m_thread_states, [thread_id](const auto& ts) { return ts->thread_id == thread_id; });
+    if (it == m_thread_states.end())
+    {
+        auto& ts = m_thread_states.emplace_back(std::make_unique<ThreadStates>());
+        ts->thread_id = thread_id;
+        ts->states.reserve(1025);
+        it = std::prev(m_thread_states.end());
+    }
+    last = {m_id, it->get()};
+    return *last.states;
+}
+
 ExecutionState& VM::get_execution_state(size_t depth) noexcept
 {
     // Vector already has the capacity for all possible depths,
     // so reallocation never happens (therefore: noexcept).
     // The ExecutionStates are lazily created because they pre-allocate EVM memory and stack.
-    assert(depth < m_execution_states.capacity());
-    if (m_execution_states.size() <= depth)
-        m_execution_states.resize(depth + 1);
-    return m_execution_states[depth];
+    auto* states = &m_execution_states;
+    auto* arena = &m_stack_arena;
+    if (concurrent)
+    {
+        auto& ts = get_thread_states();
+        states = &ts.states;
+        arena = &ts.arena;
+    }
+
+    assert(depth < states->capacity());
+    if (states->size() <= depth)
+    {
+        // The stacks of the consecutive depths are adjacent in the arena.
+        const auto use_arena = stack_arena && arena->reserve();
+        while (states->size() <= depth)
+        {
+            if (use_arena)
+                states->emplace_back(arena->frame(states->size()));
+            else
+                states->emplace_back();
+        }
+    }
+
+    // Apply the options also to the reused state: they may have changed or the memory grown
+    // above the reservation may have moved to the heap.
+    // The state of this depth is not in use and is reset by the caller anyway.
+    auto& state = (*states)[depth];
+    if (stack_arena != state.stack_space.external()) [[unlikely]]
+    {
+        if (!stack_arena)
+            state.stack_space = StackSpace{};
+        else if (arena->reserve())
+            state.stack_space = StackSpace{arena->frame(depth)};
+    }
+    if (mapped_memory != state.memory.is_mapped()) [[unlikely]]
+    {
+        if (mapped_memory)
+            state.memory.reserve_mapping();  // Stays in the default mode on failure.
+        else
+            state.memory.release_mapping();
+    }
+    if (storage_cache != state.storage_cache.enabled()) [[unlikely]]
+    {
+        if (storage_cache)
+            state.storage_cache.enable();
+        else
+            state.storage_cache.disable();
+    }
+    return state;
+}
+
+std::shared_ptr<const baseline::CodeAnalysis> VM::get_cached_analysis(
+    bytes_view code, bool eof_enabled, const baseline::AnalysisOptions& options)
+{
+    if (!concurrent)
+        return m_analysis_cache.get(code, eof_enabled, options);
+
+    {
+        const std::shared_lock lock{m_analysis_cache_mutex};
+        if (auto analysis = m_analysis_cache.find(code, eof_enabled, options))
+            return analysis;
+    }
+
+    // Analyze without blocking other threads. If another thread inserts the same code
+    // meanwhile, its analysis is used and this one is discarded.
+    auto entry = m_analysis_cache.make_entry(code, eof_enabled, options);
+    const std::lock_guard lock{m_analysis_cache_mutex};
+    return m_analysis_cache.insert(std::move(entry));
 }
 
 }  // namespace evmone
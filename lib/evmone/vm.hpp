@@ -3,9 +3,16 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include "analysis_cache.hpp"
+#include "baseline_aot.hpp"
 #include "execution_state.hpp"
+#include "stack_arena.hpp"
 #include "tracing.hpp"
 #include <evmc/evmc.h>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include <vector>
 
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -14,6 +21,12 @@
 #define EVMONE_CGOTO_SUPPORTED 1
 #endif
 
+#if __has_cpp_attribute(clang::musttail)
+#define EVMONE_TAILCALL_SUPPORTED 1
+#else
+#define EVMONE_TAILCALL_SUPPORTED 0
+#endif
+
 namespace evmone
 {
 /// The evmone EVMC instance.
@@ -21,16 +34,68 @@ class VM : public evmc_vm
 {
 public:
     bool cgoto = EVMONE_CGOTO_SUPPORTED;
+    bool tailcall = false;
     bool validate_eof = false;
+    bool superinstructions = false;
+    bool block_checks = false;
+    bool jit = false;
+
+    /// Allows the concurrent execute() calls from multiple threads.
+    /// The options, the tracers, the AOT contracts and the analysis cache file must be set
+    /// before the VM is shared between threads. The tracers are not supported concurrently.
+    bool concurrent = false;
+
+    /// Places the EVM stacks of the execution states in the StackArena.
+    /// Applied to the existing states when they are reused.
+    bool stack_arena = false;
+
+    /// Uses the mapped mode of the EVM memory of the execution states.
+    /// Applied to the existing states when they are reused.
+    bool mapped_memory = false;
+
+    /// Enables the StorageCache of the execution states.
+    /// Applied to the existing states when they are reused.
+    bool storage_cache = false;
+
+    /// Returns the output of the nested calls (depth > 0) referencing the frame memory without
+    /// copying. The output is valid until the calling frame makes the next call, so the host
+    /// must not keep the result of the nested call after passing it to the calling frame.
+    bool zero_copy_output = false;
 
 private:
+    /// The execution states of the thread indexed by the call depth.
+    struct ThreadStates
+    {
+        std::thread::id thread_id;
+        StackArena arena;
+        std::vector<ExecutionState> states;
+    };
+
+    /// The arena of the stacks of m_execution_states. Must outlive the execution states.
+    StackArena m_stack_arena;
     std::vector<ExecutionState> m_execution_states;
     std::unique_ptr<Tracer> m_first_tracer;
+    baseline::AnalysisCache m_analysis_cache;
+    baseline::AotRegistry m_aot_registry;
+
+    /// The unique id of the VM instance to find the thread's execution states of this VM.
+    const uint64_t m_id;
+
+    /// The execution states of the threads in the concurrent mode.
+    /// The elements are never removed so the thread-local references to them stay valid.
+    std::vector<std::unique_ptr<ThreadStates>> m_thread_states;
+    std::mutex m_thread_states_mutex;
+
+    /// The lock of the analysis cache in the concurrent mode: shared by the lookups,
+    /// exclusive for the insertion.
+    std::shared_mutex m_analysis_cache_mutex;
+
+    [[nodiscard]] ThreadStates& get_thread_states() noexcept;
 
 public:
     VM() noexcept;
 
-    [[nodiscard]] ExecutionState& get_execution_state(size_t depth) noexcept;
+    [[nodiscard]] EVMC_EXPORT ExecutionState& get_execution_state(size_t depth) noexcept;
 
     void add_tracer(std::unique_ptr<Tracer> tracer) noexcept
     {
@@ -44,5 +109,17 @@ public:
     void remove_tracers() noexcept { m_first_tracer.reset(); }
 
     [[nodiscard]] Tracer* get_tracer() const noexcept { return m_first_tracer.get(); }
+
+    [[nodiscard]] baseline::AnalysisCache& get_analysis_cache() noexcept
+    {
+        return m_analysis_cache;
+    }
+
+    /// Gets the code analysis from the analysis cache. Synchronized in the concurrent mode:
+    /// the code missing in the cache is analyzed without holding the lock.
+    [[nodiscard]] std::shared_ptr<const baseline::CodeAnalysis> get_cached_analysis(
+        bytes_view code, bool eof_enabled, const baseline::AnalysisOptions& options);
+
+    [[nodiscard]] baseline::AotRegistry& get_aot_registry() noexcept { return m_aot_registry; }
 };
 }  // namespace evmone
@@ -0,0 +1,227 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// The ahead-of-time compiler of the legacy contracts.
+///
+/// Translates the contract code to C++ executing the instructions with the Baseline
+/// implementations. The instructions between the JUMPDESTs are executed as straight-line code
+/// and the jumps continue at the labels of the JUMPDESTs. The output is compiled to a shared
+/// object loaded by the VM with the "aot" option.
+
+#include <CLI/CLI.hpp>
+#include <ethash/keccak.hpp>
+#include <evmc/evmc.hpp>
+#include <evmone/baseline_aot.hpp>
+#include <evmone/eof.hpp>
+#include <evmone/instructions_traits.hpp>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace evmone;
+
+constexpr auto HELP_FOOTER = R"(
+The tool reads the hex-encoded legacy contract codes from the input file (or stdin), one per line,
+and writes C++.
+Compile it to a shared object with the headers of the same evmone version:
+
+  c++ -std=c++20 -O2 -shared -fPIC -I<evmone>/lib -I<evmc>/include -I<intx>/include \
+      -I<ethash>/include contracts.cpp -o contracts.so
+
+and load it in the VM with the option aot=contracts.so.
+)";
+
+/// The reachable instruction of the code.
+struct Instruction
+{
+    size_t position = 0;
+    uint8_t op = 0;
+};
+
+/// Checks if the opcode is defined for the legacy code in any revision.
+bool is_defined(uint8_t op) noexcept
+{
+    const auto& tr = instr::traits[op];
+    return tr.name != nullptr && tr.since.has_value();
+}
+
+/// Returns the size of the instruction immediate in the legacy code. Only the PUSH instructions
+/// have immediates there: the bytes after the EOF instructions are the next instructions,
+/// like in the jumpdest analysis.
+constexpr size_t legacy_immediate_size(uint8_t op) noexcept
+{
+    return (op >= OP_PUSH1 && op <= OP_PUSH32) ? static_cast<size_t>(op - OP_PUSH0) : 0;
+}
+
+/// Returns the instructions of the code except the ones unreachable after the terminating
+/// instructions and the jumps, up to the next JUMPDEST.
+std::vector<Instruction> find_reachable_instructions(evmc::bytes_view code)
+{
+    std::vector<Instruction> instructions;
+    bool reachable = true;
+    for (size_t i = 0; i < code.size(); i += 1 + legacy_immediate_size(code[i]))
+    {
+        const auto op = code[i];
+        if (op == OP_JUMPDEST)
+            reachable = true;
+        if (!reachable)
+            continue;
+
+        instructions.push_back({i, op});
+        if (op == OP_JUMP || !is_defined(op) || instr::traits[op].is_terminating)
+            reachable = false;
+    }
+    return instructions;
+}
+
+void compile_contract(std::ostream& out, evmc::bytes_view code, size_t index)
+{
+    const auto instructions = find_reachable_instructions(code);
+    bool has_jumps = false;
+    for (const auto& ins : instructions)
+        has_jumps |= (ins.op == OP_JUMP || ins.op == OP_JUMPI);
+
+    out << "int64_t contract_" << index
+        << "(ExecutionState& state, int64_t gas, const AotSupport& support) noexcept\n"
+        << "{\n"
+        << "    AotFrame f{state, gas, support};\n";
+
+    bool reachable = true;
+    size_t end = 0;
+    for (const auto& [pos, op] : instructions)
+    {
+        if (op == OP_JUMPDEST && has_jumps)
+            out << "L_" << pos << ":\n";
+
+        if (!is_defined(op))
+        {
+            out << "    f.undefined();\n"
+                << "    return f.gas;\n";
+            reachable = false;
+            continue;
+        }
+
+        out << "    if (!f.step<OP_" << instr::traits[op].name << ">(" << pos
+            << ")) return f.gas;\n";
+        if (op == OP_JUMP)
+            out << "    goto dispatch;\n";
+        else if (op == OP_JUMPI)
+            out << "    if (f.next_position() != " << pos + 1 << ") goto dispatch;\n";
+
+        reachable = (op != OP_JUMP && !instr::traits[op].is_terminating);
+        end = pos + 1 + legacy_immediate_size(op);
+    }
+
+    // The final STOP from the code padding.
+    if (reachable)
+        out << "    f.step<OP_STOP>(" << end << ");\n"
+            << "    return f.gas;\n";
+
+    if (has_jumps)
+    {
+        out << "dispatch:\n"
+            << "    switch (f.next_position())\n"
+            << "    {\n";
+        for (const auto& [pos, op] : instructions)
+        {
+            if (op == OP_JUMPDEST)
+                out << "    case " << pos << ":\n"
+                    << "        goto L_" << pos << ";\n";
+        }
+        out << "    default:\n"
+            << "        f.undefined();\n"
+            << "        return f.gas;\n"
+            << "    }\n";
+    }
+    out << "}\n\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        CLI::App app{"evmone ahead-of-time contract compiler"};
+        app.footer(HELP_FOOTER);
+        std::string input_file;
+        std::string output_file;
+        app.add_option("input", input_file, "The file with the contract codes (stdin by default)")
+            ->check(CLI::ExistingFile);
+        app.add_option("-o,--output", output_file, "The output C++ file (stdout by default)");
+
+        CLI11_PARSE(app, argc, argv);
+
+        std::ifstream input_fstream;
+        if (!input_file.empty())
+            input_fstream.open(input_file);
+        auto& in = input_file.empty() ? std::cin : input_fstream;
+
+        std::vector<evmc::bytes> codes;
+        for (std::string line; std::getline(in, line);)
+        {
+            if (line.empty() || line.starts_with('#'))
+                continue;
+
+            auto code = evmc::from_hex(line);
+            if (!code)
+            {
+                std::cerr << "err: invalid hex: " << line << "\n";
+                return 1;
+            }
+            if (is_eof_container(*code))
+            {
+                std::cerr << "err: EOF code is not supported: " << line << "\n";
+                return 1;
+            }
+            codes.emplace_back(std::move(*code));
+        }
+        if (codes.empty())
+        {
+            std::cerr << "err: no contracts\n";
+            return 1;
+        }
+
+        std::ofstream output_fstream;
+        if (!output_file.empty())
+            output_fstream.open(output_file);
+        auto& out = output_file.empty() ? std::cout : output_fstream;
+
+        out << "// Generated by evmone-aotc.\n\n"
+            << "#include <evmone/baseline_aot_runtime.hpp>\n\n"
+            << "using namespace evmone;\n"
+            << "using namespace evmone::baseline;\n"
+            << "using namespace evmc::literals;\n\n"
+            << "namespace\n"
+            << "{\n";
+        for (size_t i = 0; i < codes.size(); ++i)
+            compile_contract(out, codes[i], i);
+        out << "}  // namespace\n\n";
+
+        out << "extern \"C\" EVMC_EXPORT const AotContract* " << baseline::AOT_CONTRACTS_SYMBOL
+            << "(uint32_t* abi_version, size_t* num_contracts)\n"
+            << "{\n"
+            << "    static const AotContract contracts[] = {\n";
+        for (size_t i = 0; i < codes.size(); ++i)
+        {
+            const auto hash = ethash::keccak256(codes[i].data(), codes[i].size());
+            out << "        {0x" << evmc::hex({hash.bytes, sizeof(hash)}) << "_bytes32, "
+                << codes[i].size() << ", contract_" << i << "},\n";
+        }
+        out << "    };\n"
+            << "    *abi_version = AOT_ABI_VERSION;\n"
+            << "    *num_contracts = " << codes.size() << ";\n"
+            << "    return contracts;\n"
+            << "}\n";
+        return out ? 0 : 1;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << "\n";
+        return -1;
+    }
+}
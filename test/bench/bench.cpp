@@ -9,10 +9,12 @@
 #include <evmc/evmc.hpp>
 #include <evmc/loader.h>
 #include <evmone/evmone.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <span>
+#include <thread>
 
 namespace fs = std::filesystem;
 
@@ -24,6 +26,9 @@ std::map<std::string_view, evmc::VM> registered_vms;
 
 namespace
 {
+/// The VM shared by the benchmark threads in the multithreaded throughput benchmarks.
+evmc::VM concurrent_vm;
+
 struct BenchmarkCase
 {
     struct Input
@@ -106,12 +111,26 @@ void register_benchmarks(std::span<const BenchmarkCase> benchmark_cases)
     evmc::VM* advanced_vm = nullptr;
     evmc::VM* baseline_vm = nullptr;
     evmc::VM* basel_cg_vm = nullptr;
+    evmc::VM* bfused_vm = nullptr;
+    evmc::VM* bblocks_vm = nullptr;
+    evmc::VM* btailcall_vm = nullptr;
+    evmc::VM* bjit_vm = nullptr;
     if (const auto it = registered_vms.find("advanced"); it != registered_vms.end())
         advanced_vm = &it->second;
     if (const auto it = registered_vms.find("baseline"); it != registered_vms.end())
         baseline_vm = &it->second;
     if (const auto it = registered_vms.find("bnocgoto"); it != registered_vms.end())
         basel_cg_vm = &it->second;
+    if (const auto it = registered_vms.find("bfused"); it != registered_vms.end())
+        bfused_vm = &it->second;
+    if (const auto it = registered_vms.find("bblocks"); it != registered_vms.end())
+        bblocks_vm = &it->second;
+    if (const auto it = registered_vms.find("btailcall"); it != registered_vms.end())
+        btailcall_vm = &it->second;
+    if (const auto it = registered_vms.find("bjit"); it != registered_vms.end())
+        bjit_vm = &it->second;
+
+    const auto max_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
 
     for (const auto& b : benchmark_cases)
     {
@@ -129,6 +148,33 @@ void register_benchmarks(std::span<const BenchmarkCase> benchmark_cases)
                 bench_analyse<baseline::CodeAnalysis, baseline_analyse>(
                     state, default_revision, b.code);
             })->Unit(kMicrosecond);
+
+            for (const auto impl : {"scalar", "sse2", "avx2", "neon"})
+            {
+                const auto fn = baseline::get_jumpdest_analysis_fn(impl);
+                if (fn == nullptr)
+                    continue;
+                RegisterBenchmark(
+                    std::string{"baseline/jumpdest_analysis/"} + impl + '/' + b.name,
+                    [fn, &b](State& state) { bench_jumpdest_analysis(state, fn, b.code); })
+                    ->Unit(kMicrosecond);
+            }
+        }
+
+        if (bblocks_vm != nullptr)
+        {
+            RegisterBenchmark("bblocks/analyse/" + b.name, [&b](State& state) {
+                bench_analyse<baseline::CodeAnalysis, baseline_blocks_analyse>(
+                    state, default_revision, b.code);
+            })->Unit(kMicrosecond);
+        }
+
+        if (bjit_vm != nullptr)
+        {
+            RegisterBenchmark("bjit/analyse/" + b.name, [&b](State& state) {
+                bench_analyse<baseline::CodeAnalysis, baseline_jit_analyse>(
+                    state, default_revision, b.code);
+            })->Unit(kMicrosecond);
         }
 
         for (const auto& input : b.inputs)
@@ -159,6 +205,41 @@ void register_benchmarks(std::span<const BenchmarkCase> benchmark_cases)
                 })->Unit(kMicrosecond);
             }
 
+            if (btailcall_vm != nullptr)
+            {
+                const auto name = "btailcall/execute/" + case_name;
+                RegisterBenchmark(name, [&vm = *btailcall_vm, &b, &input](State& state) {
+                    bench_baseline_execute(state, vm, b.code, input.input, input.expected_output);
+                })->Unit(kMicrosecond);
+            }
+
+            if (bfused_vm != nullptr)
+            {
+                const auto name = "bfused/execute/" + case_name;
+                RegisterBenchmark(name, [&vm = *bfused_vm, &b, &input](State& state) {
+                    bench_baseline_fused_execute(
+                        state, vm, b.code, input.input, input.expected_output);
+                })->Unit(kMicrosecond);
+            }
+
+            if (bblocks_vm != nullptr)
+            {
+                const auto name = "bblocks/execute/" + case_name;
+                RegisterBenchmark(name, [&vm = *bblocks_vm, &b, &input](State& state) {
+                    bench_baseline_blocks_execute(
+                        state, vm, b.code, input.input, input.expected_output);
+                })->Unit(kMicrosecond);
+            }
+
+            if (bjit_vm != nullptr)
+            {
+                const auto name = "bjit/execute/" + case_name;
+                RegisterBenchmark(name, [&vm = *bjit_vm, &b, &input](State& state) {
+                    bench_baseline_jit_execute(
+                        state, vm, b.code, input.input, input.expected_output);
+                })->Unit(kMicrosecond);
+            }
+
             for (auto& [vm_name, vm] : registered_vms)
             {
                 const auto name = std::string{vm_name} + "/total/" + case_name;
@@ -166,6 +247,19 @@ void register_benchmarks(std::span<const BenchmarkCase> benchmark_cases)
                     bench_evmc_execute(state, vm_, b.code, input.input, input.expected_output);
                 })->Unit(kMicrosecond);
             }
+
+            if (concurrent_vm)
+            {
+                // The throughput of the single VM executing in the increasing number of threads.
+                const auto name = "bconcurrent/total/" + case_name;
+                RegisterBenchmark(name, [&b, &input](State& state) {
+                    bench_evmc_execute(
+                        state, concurrent_vm, b.code, input.input, input.expected_output);
+                })
+                    ->Unit(kMicrosecond)
+                    ->ThreadRange(1, max_threads)
+                    ->UseRealTime();
+            }
         }
     }
 }
@@ -274,6 +368,17 @@ int main(int argc, char** argv)
         registered_vms["advanced"] = evmc::VM{evmc_create_evmone(), {{"advanced", ""}}};
         registered_vms["baseline"] = evmc::VM{evmc_create_evmone()};
         registered_vms["bnocgoto"] = evmc::VM{evmc_create_evmone(), {{"cgoto", "no"}}};
+        registered_vms["bfused"] = evmc::VM{evmc_create_evmone(), {{"superinstructions", "yes"}}};
+        registered_vms["bblocks"] = evmc::VM{evmc_create_evmone(), {{"block_checks", "yes"}}};
+        if (evmc::VM btailcall{evmc_create_evmone()};
+            btailcall.set_option("dispatch", "tailcall") == EVMC_SET_OPTION_SUCCESS)
+            registered_vms["btailcall"] = std::move(btailcall);
+        if (evmc::VM bjit{evmc_create_evmone()};
+            bjit.set_option("jit", "yes") == EVMC_SET_OPTION_SUCCESS &&
+            bjit.set_option("analysis_cache", "64") == EVMC_SET_OPTION_SUCCESS)
+            registered_vms["bjit"] = std::move(bjit);
+        concurrent_vm =
+            evmc::VM{evmc_create_evmone(), {{"concurrent", "yes"}, {"analysis_cache", "64"}}};
         register_benchmarks(benchmark_cases);
         register_synthetic_benchmarks();
         RunSpecifiedBenchmarks();
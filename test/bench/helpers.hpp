@@ -45,6 +45,21 @@ inline baseline::CodeAnalysis baseline_analyse(evmc_revision /*rev*/, bytes_view
     return baseline::analyze(code, true);  // Always enable EOF.
 }
 
+inline baseline::CodeAnalysis baseline_fused_analyse(evmc_revision /*rev*/, bytes_view code)
+{
+    return baseline::analyze(code, true, {.superinstructions = true});  // Always enable EOF.
+}
+
+inline baseline::CodeAnalysis baseline_blocks_analyse(evmc_revision rev, bytes_view code)
+{
+    return baseline::analyze(code, true, {.block_checks = true, .rev = rev});  // Always enable EOF.
+}
+
+inline baseline::CodeAnalysis baseline_jit_analyse(evmc_revision rev, bytes_view code)
+{
+    return baseline::analyze(code, true, {.jit = true, .rev = rev});  // Always enable EOF.
+}
+
 inline FakeCodeAnalysis evmc_analyse(evmc_revision /*rev*/, bytes_view /*code*/)
 {
     return {};
@@ -93,6 +108,25 @@ inline void bench_analyse(benchmark::State& state, evmc_revision rev, bytes_view
 }
 
 
+inline void bench_jumpdest_analysis(
+    benchmark::State& state, baseline::JumpdestAnalysisFn analysis_fn, bytes_view code) noexcept
+{
+    std::vector<baseline::CodeAnalysis::JumpdestWord> bitset(
+        baseline::CodeAnalysis::jumpdest_bitset_num_words(code.size()));
+    auto bytes_analysed = uint64_t{0};
+    for (auto _ : state)
+    {
+        analysis_fn(code, bitset.data());
+        benchmark::DoNotOptimize(bitset.data());
+        bytes_analysed += code.size();
+    }
+
+    using benchmark::Counter;
+    state.counters["size"] = Counter(static_cast<double>(code.size()));
+    state.counters["rate"] = Counter(static_cast<double>(bytes_analysed), Counter::kIsRate);
+}
+
+
 template <typename ExecutionStateT, typename AnalysisT,
     ExecuteFn<ExecutionStateT, AnalysisT> execute_fn, AnalyseFn<AnalysisT> analyse_fn>
 inline void bench_execute(benchmark::State& state, evmc::VM& vm, bytes_view code, bytes_view input,
@@ -152,6 +186,15 @@ constexpr auto bench_advanced_execute = bench_execute<advanced::AdvancedExecutio
 constexpr auto bench_baseline_execute =
     bench_execute<ExecutionState, baseline::CodeAnalysis, baseline_execute, baseline_analyse>;
 
+constexpr auto bench_baseline_fused_execute = bench_execute<ExecutionState,
+    baseline::CodeAnalysis, baseline_execute, baseline_fused_analyse>;
+
+constexpr auto bench_baseline_blocks_execute = bench_execute<ExecutionState,
+    baseline::CodeAnalysis, baseline_execute, baseline_blocks_analyse>;
+
+constexpr auto bench_baseline_jit_execute = bench_execute<ExecutionState, baseline::CodeAnalysis,
+    baseline_execute, baseline_jit_analyse>;
+
 inline void bench_evmc_execute(benchmark::State& state, evmc::VM& vm, bytes_view code,
     bytes_view input = {}, bytes_view expected_output = {})
 {
@@ -202,6 +202,64 @@ bytecode generate_loop_v2(const bytecode& inner_code)
            push(jumpdest_offset) + OP_JUMPI;     // jump to jumpdest_offset if counter != 0
 }
 
+/// Returns the PUSH2 of the code offset.
+bytecode push2(size_t offset)
+{
+    const uint8_t data[]{static_cast<uint8_t>(offset >> 8), static_cast<uint8_t>(offset)};
+    return push(OP_PUSH2, bytecode{data, std::size(data)});
+}
+
+/// Generates a benchmark loop jumping through the given number of basic blocks in shuffled order.
+///
+/// Every block is JUMPDEST PUSH2 JUMP so the execution is dominated by the jump destination
+/// lookups with the targets spread over the whole code. The loop is the same as in v2.
+bytecode generate_jump_around(size_t num_blocks)
+{
+    // The stride of the visiting order. It is coprime with the supported numbers of blocks.
+    constexpr size_t stride = 7919;
+    constexpr size_t block_size = 5;  // JUMPDEST PUSH2 JUMP
+
+    const auto counter =
+        push("ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff01");  // -255
+    const auto loop_offset = counter.size();
+    const auto blocks_offset = loop_offset + block_size;
+    const auto exit_offset = blocks_offset + num_blocks * block_size;
+
+    // The index of the block visited as the i-th.
+    const auto visited = [num_blocks](size_t i) { return i * stride % num_blocks; };
+    const auto offset_of = [blocks_offset](size_t b) { return blocks_offset + b * block_size; };
+
+    // The block visited as the i-th jumps to the (i+1)-th one, the last one to the loop exit.
+    std::vector<size_t> targets(num_blocks);
+    for (size_t i = 0; i < num_blocks; ++i)
+        targets[visited(i)] = i + 1 < num_blocks ? offset_of(visited(i + 1)) : exit_offset;
+
+    auto code = counter + OP_JUMPDEST + push2(offset_of(visited(0))) + OP_JUMP;
+    for (const auto target : targets)
+        code += OP_JUMPDEST + push2(target) + OP_JUMP;
+    return code + OP_JUMPDEST +           // loop exit label
+           push(1) + OP_ADD + OP_DUP1 +   // counter += 1
+           push(loop_offset) + OP_JUMPI;  // jump to loop_offset if counter != 0
+}
+
+/// The order of the BN254 scalar field.
+constexpr auto bn254_r = intx::from_string<intx::uint256>(
+    "0x30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001");
+
+/// Generates a benchmark loop of the chain of the modular squarings by the given modulus.
+///
+/// This is the field arithmetic of the elliptic curve based proof verifiers, e.g. the Fermat
+/// inversion in the BN254 scalar field. Every squaring depends on the previous one.
+/// The loop is the same as in v2.
+bytecode generate_mulmod_chain(const intx::uint256& mod)
+{
+    constexpr int chain_length = 32;
+
+    // The stack is [mod, x] after each step.
+    const auto square = bytecode{OP_DUP2} + OP_SWAP1 + OP_DUP1 + OP_MULMOD;
+    return generate_loop_v2(push(mod) + OP_DUP2 + chain_length * square + OP_POP + OP_POP);
+}
+
 bytes_view generate_code(CodeParams params)
 {
     static std::map<CodeParams, bytecode> cache;
@@ -259,6 +317,31 @@ void register_synthetic_benchmarks()
             [&vm_ = vm](State& state) { bench_evmc_execute(state, vm_, generate_loop_v2({})); });
     }
 
+    for (const auto num_blocks : {16u, 256u, 4096u})
+    {
+        for (auto& [vm_name, vm] : registered_vms)
+        {
+            RegisterBenchmark(
+                std::string{vm_name} + "/total/synth/jump_around/" + std::to_string(num_blocks),
+                [&vm_ = vm, code = generate_jump_around(num_blocks)](
+                    State& state) { bench_evmc_execute(state, vm_, code); })
+                ->Unit(kMicrosecond);
+        }
+    }
+
+    // The even modulus of the same size as the BN254 one is not cached.
+    for (const auto& [mod_name, mod] :
+        {std::pair{"bn254", bn254_r}, std::pair{"even", bn254_r + 1}})
+    {
+        for (auto& [vm_name, vm] : registered_vms)
+        {
+            RegisterBenchmark(std::string{vm_name} + "/total/synth/mulmod_chain/" + mod_name,
+                [&vm_ = vm, code = generate_mulmod_chain(mod)](
+                    State& state) { bench_evmc_execute(state, vm_, code); })
+                ->Unit(kMicrosecond);
+        }
+    }
+
     for (const auto params : params_list)
     {
         for (auto& [vm_name, vm] : registered_vms)
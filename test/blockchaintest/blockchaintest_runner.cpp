@@ -28,16 +28,16 @@ struct TransitionResult
     int64_t gas_used;
     state::BloomFilter bloom;
     int64_t blob_gas_left;
-    TestState block_state;
+    TestStateOverlay block_state;
 };
 
 namespace
 {
-TransitionResult apply_block(TestState& state, evmc::VM& vm, const state::BlockInfo& block,
+TransitionResult apply_block(const TestState& state, evmc::VM& vm, const state::BlockInfo& block,
     const state::BlockHashes& block_hashes, const std::vector<state::Transaction>& txs,
     evmc_revision rev, std::optional<int64_t> block_reward)
 {
-    TestState block_state(state);
+    TestStateOverlay block_state{state};
     system_call_block_start(block_state, block, block_hashes, rev, vm);
 
     std::vector<state::Log> txs_logs;
@@ -209,7 +209,7 @@ void run_blockchain_tests(std::span<const BlockchainTest> tests, evmc::VM& vm)
 
                 block_hashes[test_block.expected_block_header.block_number] =
                     test_block.expected_block_header.hash;
-                state = res.block_state;
+                state.apply(res.block_state.diff());
 
                 EXPECT_TRUE(res.rejected.empty())
                     << "Invalid transaction in block expected to be valid";
@@ -275,7 +275,7 @@ void run_blockchain_tests(std::span<const BlockchainTest> tests, evmc::VM& vm)
                 // the test already has gone into failed state here.
                 block_hashes[test_block.expected_block_header.block_number] =
                     test_block.expected_block_header.hash;
-                state = res.block_state;
+                state.apply(res.block_state.diff());
             }
         }
         const auto expected_post_hash =
@@ -0,0 +1,82 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+#include <evmone/instructions.hpp>
+#include <array>
+
+using evmone::uint256;
+using namespace intx::literals;
+namespace core = evmone::instr::core;
+
+namespace
+{
+/// Returns the value of the given number of significant bits.
+uint256 value_of_width(unsigned bits) noexcept
+{
+    constexpr auto pattern =
+        0x9e3779b97f4a7c15cdeb8272fc01d4d50a6ec165d2ea477af19b9b2c198459f5_u256;
+    return pattern >> (256 - bits);
+}
+
+/// Benchmarks the binary arithmetic instruction with the operands of the given width:
+/// the first operand of the full width and the second one of the half width.
+template <void Fn(evmone::StackTop) noexcept, unsigned Bits>
+void binop(benchmark::State& state)
+{
+    const auto x = value_of_width(Bits);
+    const auto y = value_of_width(Bits / 2);
+
+    std::array<uint256, 2> stack;
+    for ([[maybe_unused]] auto _ : state)
+    {
+        stack = {y, x};
+        Fn(&stack[1]);
+        benchmark::DoNotOptimize(stack);
+    }
+}
+
+/// Benchmarks EXP with the base of 10 (like 10**decimals) and the exponent of the given width.
+/// The width of 8 means the exponent of 18.
+template <unsigned Bits>
+void exp_base10(benchmark::State& state)
+{
+    const auto exponent = Bits == 8 ? uint256{18} : value_of_width(Bits);
+
+    evmone::ExecutionState execution_state;
+    execution_state.rev = EVMC_CANCUN;
+    std::array<uint256, 2> stack;
+    for ([[maybe_unused]] auto _ : state)
+    {
+        stack = {exponent, 10};
+        benchmark::DoNotOptimize(core::exp(&stack[1], 1'000'000, execution_state));
+        benchmark::DoNotOptimize(stack);
+    }
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(binop, core::add, 64);
+BENCHMARK_TEMPLATE(binop, core::add, 128);
+BENCHMARK_TEMPLATE(binop, core::add, 256);
+BENCHMARK_TEMPLATE(binop, core::mul, 64);
+BENCHMARK_TEMPLATE(binop, core::mul, 128);
+BENCHMARK_TEMPLATE(binop, core::mul, 256);
+BENCHMARK_TEMPLATE(binop, core::div, 64);
+BENCHMARK_TEMPLATE(binop, core::div, 128);
+BENCHMARK_TEMPLATE(binop, core::div, 256);
+BENCHMARK_TEMPLATE(binop, core::sdiv, 64);
+BENCHMARK_TEMPLATE(binop, core::sdiv, 128);
+BENCHMARK_TEMPLATE(binop, core::sdiv, 256);
+BENCHMARK_TEMPLATE(binop, core::mod, 64);
+BENCHMARK_TEMPLATE(binop, core::mod, 128);
+BENCHMARK_TEMPLATE(binop, core::mod, 256);
+BENCHMARK_TEMPLATE(binop, core::smod, 64);
+BENCHMARK_TEMPLATE(binop, core::smod, 128);
+BENCHMARK_TEMPLATE(binop, core::smod, 256);
+BENCHMARK_TEMPLATE(binop, core::lt, 64);
+BENCHMARK_TEMPLATE(binop, core::lt, 128);
+BENCHMARK_TEMPLATE(binop, core::lt, 256);
+BENCHMARK_TEMPLATE(exp_base10, 8);
+BENCHMARK_TEMPLATE(exp_base10, 64);
+BENCHMARK_TEMPLATE(exp_base10, 256);
@@ -53,6 +53,36 @@ void evmmax_mul(benchmark::State& state)
         b = m.mul(b, a);
     }
 }
+
+/// The modular multiplication of the values in the normal form as in MULMOD: by division.
+template <const uint256& Mod>
+void mulmod_division(benchmark::State& state)
+{
+    auto a = Mod / 2;
+    auto b = Mod / 3;
+
+    while (state.KeepRunningBatch(2))
+    {
+        a = mulmod(a, b, Mod);
+        b = mulmod(b, a, Mod);
+    }
+}
+
+/// The modular multiplication of the values in the normal form as in MULMOD: by two Montgomery
+/// multiplications with the ModArith created once.
+template <const uint256& Mod>
+void mulmod_montgomery(benchmark::State& state)
+{
+    const evmmax::ModArith<uint256> m{Mod};
+    auto a = Mod / 2;
+    auto b = Mod / 3;
+
+    while (state.KeepRunningBatch(2))
+    {
+        a = m.mul(m.to_mont(a), b);
+        b = m.mul(m.to_mont(b), a);
+    }
+}
 }  // namespace
 
 BENCHMARK_TEMPLATE(evmmax_add, uint256, bn254);
@@ -61,3 +91,7 @@ BENCHMARK_TEMPLATE(evmmax_sub, uint256, bn254);
 BENCHMARK_TEMPLATE(evmmax_sub, uint256, secp256k1);
 BENCHMARK_TEMPLATE(evmmax_mul, uint256, bn254);
 BENCHMARK_TEMPLATE(evmmax_mul, uint256, secp256k1);
+BENCHMARK_TEMPLATE(mulmod_division, bn254);
+BENCHMARK_TEMPLATE(mulmod_division, secp256k1);
+BENCHMARK_TEMPLATE(mulmod_montgomery, bn254);
+BENCHMARK_TEMPLATE(mulmod_montgomery, secp256k1);
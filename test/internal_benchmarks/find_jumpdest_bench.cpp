@@ -4,8 +4,10 @@
 
 #include <benchmark/benchmark.h>
 #include <array>
+#include <bit>
 #include <random>
 #include <unordered_map>
+#include <vector>
 
 #pragma GCC diagnostic error "-Wconversion"
 
@@ -308,6 +310,145 @@ void find_jumpdest_hashmap_random(benchmark::State& state)
 BENCHMARK_TEMPLATE(find_jumpdest_hashmap_random, int);
 BENCHMARK_TEMPLATE(find_jumpdest_hashmap_random, uint16_t);
 
+
+/// The lookup in the dense map of all code offsets.
+template <typename T>
+void find_jumpdest_dense_random(benchmark::State& state)
+{
+    const auto indexes = random_indexes;
+    const auto& map = map_builder<T>::map;
+
+    std::vector<T> dense(2 * jumpdest_map_size + 1, T(-1));
+    for (const auto& [offset, target] : map)
+        dense[static_cast<size_t>(offset)] = target;
+    benchmark::ClobberMemory();
+
+    while (state.KeepRunningBatch(indexes.size()))
+    {
+        for (auto i : indexes)
+        {
+            auto x = i < dense.size() ? dense[i] : T(-1);
+            benchmark::DoNotOptimize(x);
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(find_jumpdest_dense_random, int);
+BENCHMARK_TEMPLATE(find_jumpdest_dense_random, uint16_t);
+
+
+/// The lookup in the bitmap of the code offsets with the number of the preceding set bits
+/// per word as in the advanced::AdvancedCodeAnalysis.
+template <typename T>
+void find_jumpdest_ranked_bitmap_random(benchmark::State& state)
+{
+    struct Word
+    {
+        uint64_t bits = 0;
+        uint32_t rank = 0;
+    };
+
+    const auto indexes = random_indexes;
+    const auto& map = map_builder<T>::map;
+
+    std::vector<Word> bitmap((2 * jumpdest_map_size + 1 + 63) / 64);
+    std::vector<T> targets;
+    for (const auto& [offset, target] : map)
+    {
+        const auto i = static_cast<size_t>(offset);
+        bitmap[i / 64].bits |= uint64_t{1} << (i % 64);
+        targets.push_back(target);
+    }
+    uint32_t rank = 0;
+    for (auto& word : bitmap)
+    {
+        word.rank = rank;
+        rank += static_cast<uint32_t>(std::popcount(word.bits));
+    }
+    benchmark::ClobberMemory();
+
+    while (state.KeepRunningBatch(indexes.size()))
+    {
+        for (auto i : indexes)
+        {
+            auto x = T(-1);
+            if (const auto w = size_t{i} / 64; w < bitmap.size())
+            {
+                const auto& word = bitmap[w];
+                const auto mask = uint64_t{1} << (i % 64);
+                if ((word.bits & mask) != 0)
+                {
+                    const auto before = word.bits & (mask - 1);
+                    x = targets[word.rank + static_cast<uint32_t>(std::popcount(before))];
+                }
+            }
+            benchmark::DoNotOptimize(x);
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(find_jumpdest_ranked_bitmap_random, int);
+BENCHMARK_TEMPLATE(find_jumpdest_ranked_bitmap_random, uint16_t);
+
+
+/// The jumpdest bitmap check using std::vector<bool> as the storage.
+struct vector_bool_bitset
+{
+    std::vector<bool> bits;
+
+    explicit vector_bool_bitset(size_t size) : bits(size) {}
+
+    void set(size_t index) noexcept { bits[index] = true; }
+
+    bool check(uint64_t index) const noexcept
+    {
+        return index < bits.size() && bits[static_cast<size_t>(index)];
+    }
+};
+
+/// The jumpdest bitmap check using the packed bitset words
+/// as in the baseline::CodeAnalysis::check_jumpdest().
+struct packed_bitset
+{
+    size_t size;
+    std::vector<uint64_t> words;
+
+    explicit packed_bitset(size_t s) : size{s}, words((s + 63) / 64) {}
+
+    void set(size_t index) noexcept { words[index / 64] |= uint64_t{1} << (index % 64); }
+
+    bool check(uint64_t index) const noexcept
+    {
+        if (index >= size)
+            return false;
+        return ((words[static_cast<size_t>(index / 64)] >> (index % 64)) & 1) != 0;
+    }
+};
+
+template <typename BitsetT>
+void check_jumpdest_random(benchmark::State& state)
+{
+    constexpr size_t code_size = 0x6000;
+    const auto indexes = random_indexes;
+
+    BitsetT bitset{code_size};
+    for (size_t i = 0; i < code_size; i += 3)
+        bitset.set(i);
+    benchmark::ClobberMemory();
+
+    while (state.KeepRunningBatch(indexes.size()))
+    {
+        for (auto i : indexes)
+        {
+            auto x = bitset.check(i);
+            benchmark::DoNotOptimize(x);
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(check_jumpdest_random, vector_bool_bitset);
+BENCHMARK_TEMPLATE(check_jumpdest_random, packed_bitset);
+
 }  // namespace
 
 BENCHMARK_MAIN();
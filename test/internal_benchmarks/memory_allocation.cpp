@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <benchmark/benchmark.h>
+#include <evmone/execution_state.hpp>
 #include <cstdlib>
 
 #if defined(__unix__) || defined(__APPLE__)
@@ -52,4 +53,31 @@ BENCHMARK_TEMPLATE(allocate, malloc_) ARGS;
 BENCHMARK_TEMPLATE(allocate, calloc_) ARGS;
 BENCHMARK_TEMPLATE(allocate, os_specific) ARGS;
 
+
+/// Grows the reused EVM memory to the given size in 32-byte steps, like the MSTOREs
+/// at increasing offsets in consecutive calls.
+template <bool Mapped>
+void memory_grow(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0)) * 1024;
+
+    evmone::Memory memory;
+    if (Mapped && !memory.reserve_mapping())
+    {
+        state.SkipWithError("mapped memory not supported");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        for (size_t s = 32; s <= size; s += 32)
+            memory.grow(s);
+        benchmark::DoNotOptimize(memory.data());
+        memory.clear();
+    }
+}
+
+BENCHMARK_TEMPLATE(memory_grow, false) ARGS;
+BENCHMARK_TEMPLATE(memory_grow, true) ARGS;
+
 }  // namespace
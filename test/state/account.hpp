@@ -3,9 +3,9 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include "flat_map.hpp"
 #include <evmc/evmc.hpp>
 #include <intx/intx.hpp>
-#include <unordered_map>
 
 namespace evmone::state
 {
@@ -48,10 +48,10 @@ struct Account
     bool has_initial_storage = false;
 
     /// The cached and modified account storage entries.
-    std::unordered_map<bytes32, StorageValue> storage;
+    FlatMap<bytes32, StorageValue, StorageKeyHash> storage;
 
     /// The EIP-1153 transient (transaction-level lifetime) storage.
-    std::unordered_map<bytes32, bytes32> transient_storage;
+    FlatMap<bytes32, bytes32, StorageKeyHash> transient_storage;
 
     /// The cache of the account code.
     ///
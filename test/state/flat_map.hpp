@@ -0,0 +1,355 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <evmc/evmc.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace evmone::state
+{
+/// The hash of the address for FlatMap.
+///
+/// The addresses are the parts of the keccak hashes so the hash only loads the last word.
+/// The artificial addresses (e.g. the precompiles) differ only in the last bytes,
+/// i.e. in the top bits of the word. The FlatMap mixes all bits of the hash.
+struct AddressHash
+{
+    uint64_t operator()(const evmc::address& addr) const noexcept
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, &addr.bytes[sizeof(addr) - sizeof(word)], sizeof(word));
+        return word;
+    }
+};
+
+/// The hash of the storage key for FlatMap.
+///
+/// The keys of the mappings and the dynamic arrays are keccak hashes and the keys
+/// of the fixed variables are small integers, so the first and the last words are combined.
+/// The small integers end up in the top bits of the hash. The FlatMap mixes all bits of it.
+struct StorageKeyHash
+{
+    uint64_t operator()(const evmc::bytes32& key) const noexcept
+    {
+        uint64_t first = 0;
+        uint64_t last = 0;
+        std::memcpy(&first, &key.bytes[0], sizeof(first));
+        std::memcpy(&last, &key.bytes[sizeof(key) - sizeof(last)], sizeof(last));
+        return first ^ last;
+    }
+};
+
+/// The hash map with the open-addressing index over the stable entries.
+///
+/// The index is the array of the buckets with the hash tags and the entry numbers searched
+/// by linear probing, so the lookup usually touches one cache line of the index and the entry.
+/// The entries are stored in the chunks which are never moved so the references to the values
+/// stay valid until the entry is erased (e.g. the Host keeps the StorageValue& of the slot).
+/// The entries are iterated in the insertion order except the ones reusing the erased entries.
+template <typename Key, typename Value, typename Hash>
+class FlatMap
+{
+public:
+    /// The key-value pair of the map. Compatible with the structured bindings.
+    struct Entry
+    {
+        Key first;
+        Value second;
+    };
+
+private:
+    struct Slot
+    {
+        Entry entry;
+        bool live = false;
+    };
+
+    /// The index bucket: the tag from the hash and the slot number of the entry.
+    struct Bucket
+    {
+        uint32_t tag = 0;
+        uint32_t slot = EMPTY;
+    };
+
+    static constexpr uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t ERASED = EMPTY - 1;
+    static constexpr uint32_t NONE = EMPTY;
+
+    /// The number of slots of the first chunk. Each next chunk is twice as big.
+    static constexpr size_t FIRST_CHUNK_SIZE = 8;
+    static constexpr auto FIRST_CHUNK_BITS = static_cast<size_t>(std::bit_width(FIRST_CHUNK_SIZE));
+
+    std::vector<std::unique_ptr<Slot[]>> m_chunks;
+    uint32_t m_num_slots = 0;             ///< The number of slots taken from the chunks.
+    std::vector<uint32_t> m_free_slots;  ///< The slots of the erased entries.
+
+    std::unique_ptr<Bucket[]> m_buckets;
+    size_t m_num_buckets = 0;   ///< The number of buckets: 0 or the power of 2.
+    size_t m_num_occupied = 0;  ///< The number of the buckets of the live and erased entries.
+    size_t m_size = 0;
+
+    /// Computes the hash of the key with all bits depending on all bits of the Hash result
+    /// (the finalizer of MurmurHash3).
+    static uint64_t hash(const Key& key) noexcept
+    {
+        auto h = Hash{}(key);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccd;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53;
+        h ^= h >> 33;
+        return h;
+    }
+
+    /// Returns the index of the first bucket of the hash: the top bits of the hash.
+    /// The tag is the low 32 bits so the tag and the index are independent.
+    [[nodiscard]] size_t bucket_index(uint64_t h) const noexcept
+    {
+        return static_cast<size_t>(h >> (64 - std::countr_zero(m_num_buckets)));
+    }
+
+    [[nodiscard]] Slot& slot(uint32_t n) const noexcept
+    {
+        const auto x = size_t{n} + FIRST_CHUNK_SIZE;
+        const auto chunk = static_cast<size_t>(std::bit_width(x)) - FIRST_CHUNK_BITS;
+        return m_chunks[chunk][x - (FIRST_CHUNK_SIZE << chunk)];
+    }
+
+    /// Returns the index of the bucket of the key or NONE if the key is not in the map.
+    [[nodiscard]] size_t find_bucket(const Key& key, uint64_t h) const noexcept
+    {
+        if (m_size == 0)
+            return NONE;
+        const auto tag = static_cast<uint32_t>(h);
+        for (auto i = bucket_index(h);; i = (i + 1) & (m_num_buckets - 1))
+        {
+            const auto& b = m_buckets[i];
+            if (b.slot == EMPTY)
+                return NONE;
+            if (b.tag == tag && b.slot != ERASED && slot(b.slot).entry.first == key)
+                return i;
+        }
+    }
+
+    /// Places the slot in the first free bucket of the hash. The index must have a free bucket.
+    void place(uint32_t n, uint64_t h) noexcept
+    {
+        auto i = bucket_index(h);
+        while (m_buckets[i].slot != EMPTY && m_buckets[i].slot != ERASED)
+            i = (i + 1) & (m_num_buckets - 1);
+        if (m_buckets[i].slot == EMPTY)
+            ++m_num_occupied;
+        m_buckets[i] = {static_cast<uint32_t>(h), n};
+    }
+
+    /// Rebuilds the index without the erased buckets with the capacity for the next insertion.
+    void rehash()
+    {
+        auto num_buckets = std::max(m_num_buckets, size_t{16});
+        while ((m_size + 1) * 2 > num_buckets)
+            num_buckets *= 2;
+        m_buckets.reset(new Bucket[num_buckets]);
+        m_num_buckets = num_buckets;
+        m_num_occupied = 0;
+        for (uint32_t n = 0; n < m_num_slots; ++n)
+        {
+            if (const auto& s = slot(n); s.live)
+                place(n, hash(s.entry.first));
+        }
+    }
+
+    /// Takes the free slot.
+    uint32_t allocate_slot()
+    {
+        if (!m_free_slots.empty())
+        {
+            const auto n = m_free_slots.back();
+            m_free_slots.pop_back();
+            return n;
+        }
+        if (m_num_slots == (FIRST_CHUNK_SIZE << m_chunks.size()) - FIRST_CHUNK_SIZE)
+            m_chunks.emplace_back(new Slot[FIRST_CHUNK_SIZE << m_chunks.size()]);
+        return m_num_slots++;
+    }
+
+    template <bool Const>
+    class Iterator
+    {
+        friend FlatMap;
+        friend Iterator<!Const>;
+
+        const FlatMap* m_map = nullptr;
+        uint32_t m_slot = 0;
+
+        Iterator(const FlatMap* map, uint32_t n) noexcept : m_map{map}, m_slot{n}
+        {
+            while (m_slot != m_map->m_num_slots && !m_map->slot(m_slot).live)
+                ++m_slot;
+        }
+
+    public:
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const Entry&, Entry&>;
+
+        Iterator() noexcept = default;
+
+        /// Converts the mutable iterator to the const one.
+        template <bool C>
+            requires(Const && !C)
+        Iterator(const Iterator<C>& it) noexcept : m_map{it.m_map}, m_slot{it.m_slot}
+        {}
+
+        reference operator*() const noexcept { return m_map->slot(m_slot).entry; }
+
+        auto* operator->() const noexcept { return &**this; }
+
+        Iterator& operator++() noexcept
+        {
+            *this = Iterator{m_map, m_slot + 1};
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const noexcept { return m_slot == other.m_slot; }
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatMap() noexcept = default;
+
+    FlatMap(const FlatMap& other)
+    {
+        for (const auto& [k, v] : other)
+            try_emplace(k).first->second = v;
+    }
+
+    FlatMap(FlatMap&& other) noexcept
+      : m_chunks{std::move(other.m_chunks)},
+        m_num_slots{std::exchange(other.m_num_slots, 0)},
+        m_free_slots{std::move(other.m_free_slots)},
+        m_buckets{std::move(other.m_buckets)},
+        m_num_buckets{std::exchange(other.m_num_buckets, 0)},
+        m_num_occupied{std::exchange(other.m_num_occupied, 0)},
+        m_size{std::exchange(other.m_size, 0)}
+    {
+        other.m_chunks.clear();
+        other.m_free_slots.clear();
+    }
+
+    FlatMap& operator=(const FlatMap& other)
+    {
+        if (this != &other)
+            *this = FlatMap{other};
+        return *this;
+    }
+
+    FlatMap& operator=(FlatMap&& other) noexcept
+    {
+        if (this != &other)
+        {
+            m_chunks = std::move(other.m_chunks);
+            other.m_chunks.clear();
+            m_num_slots = std::exchange(other.m_num_slots, 0);
+            m_free_slots = std::move(other.m_free_slots);
+            other.m_free_slots.clear();
+            m_buckets = std::move(other.m_buckets);
+            m_num_buckets = std::exchange(other.m_num_buckets, 0);
+            m_num_occupied = std::exchange(other.m_num_occupied, 0);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    ~FlatMap() = default;
+
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    [[nodiscard]] iterator begin() noexcept { return {this, 0}; }
+    [[nodiscard]] iterator end() noexcept { return {this, m_num_slots}; }
+    [[nodiscard]] const_iterator begin() const noexcept { return {this, 0}; }
+    [[nodiscard]] const_iterator end() const noexcept { return {this, m_num_slots}; }
+
+    [[nodiscard]] iterator find(const Key& key) noexcept
+    {
+        const auto i = find_bucket(key, hash(key));
+        return i != NONE ? iterator{this, m_buckets[i].slot} : end();
+    }
+
+    [[nodiscard]] const_iterator find(const Key& key) const noexcept
+    {
+        const auto i = find_bucket(key, hash(key));
+        return i != NONE ? const_iterator{this, m_buckets[i].slot} : end();
+    }
+
+    /// Returns the number of the buckets inspected to find the key (1 if it is in its first
+    /// bucket) or 0 if the key is not in the map. Measures the quality of the hash.
+    [[nodiscard]] size_t probe_length(const Key& key) const noexcept
+    {
+        const auto h = hash(key);
+        const auto i = find_bucket(key, h);
+        return i != NONE ? ((i - bucket_index(h)) & (m_num_buckets - 1)) + 1 : 0;
+    }
+
+    /// Inserts the entry of the key with the default value if the key is not in the map.
+    /// Returns the iterator to the entry and true if inserted.
+    std::pair<iterator, bool> try_emplace(const Key& key)
+    {
+        const auto h = hash(key);
+        if (const auto i = find_bucket(key, h); i != NONE)
+            return {iterator{this, m_buckets[i].slot}, false};
+
+        // Keep at least 1/4 of the buckets empty for short probe sequences.
+        if ((m_num_occupied + 1) * 4 > m_num_buckets * 3)
+            rehash();
+
+        const auto n = allocate_slot();
+        auto& s = slot(n);
+        s.entry.first = key;
+        s.live = true;
+        place(n, h);
+        ++m_size;
+        return {iterator{this, n}, true};
+    }
+
+    /// Inserts the entry if its key is not in the map.
+    std::pair<iterator, bool> insert(Entry&& entry)
+    {
+        const auto r = try_emplace(entry.first);
+        if (r.second)
+            r.first->second = std::move(entry.second);
+        return r;
+    }
+
+    Value& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+    /// Erases the entry of the key. Returns the number of erased entries.
+    size_t erase(const Key& key)
+    {
+        const auto i = find_bucket(key, hash(key));
+        if (i == NONE)
+            return 0;
+        const auto n = m_buckets[i].slot;
+        m_buckets[i].slot = ERASED;
+        auto& s = slot(n);
+        s.live = false;
+        s.entry.second = Value{};  // Release the resources of the value.
+        m_free_slots.push_back(n);
+        --m_size;
+        return 1;
+    }
+};
+}  // namespace evmone::state
@@ -36,6 +36,16 @@ hash256 mpt_hash(const test::TestState& state)
     return trie.hash();
 }
 
+hash256 mpt_hash(const test::TestStateOverlay& state)
+{
+    MPT trie;
+    state.for_each_account([&trie](const address& addr, const test::TestAccount& acc) {
+        trie.insert(keccak256(addr),
+            rlp::encode_tuple(acc.nonce, acc.balance, mpt_hash(acc.storage), keccak256(acc.code)));
+    });
+    return trie.hash();
+}
+
 template <typename T>
 hash256 mpt_hash(std::span<const T> list)
 {
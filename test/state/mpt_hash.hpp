@@ -9,6 +9,7 @@
 namespace evmone::test
 {
 class TestState;
+class TestStateOverlay;
 }
 
 namespace evmone::state
@@ -22,6 +23,9 @@ constexpr auto EMPTY_MPT_HASH =
 /// Computes Merkle Patricia Trie root hash for the given collection of state accounts.
 hash256 mpt_hash(const test::TestState& state);
 
+/// Computes Merkle Patricia Trie root hash for the state accounts of the layered state.
+hash256 mpt_hash(const test::TestStateOverlay& state);
+
 /// Computes Merkle Patricia Trie root hash for the given list of structures.
 template <typename T>
 hash256 mpt_hash(std::span<const T> list);
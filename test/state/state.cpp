@@ -11,6 +11,7 @@
 #include <evmone/eof.hpp>
 #include <evmone_precompiles/secp256k1.hpp>
 #include <algorithm>
+#include <cstring>
 
 using namespace intx;
 
@@ -293,13 +294,34 @@ bytes_view State::get_code(const address& addr)
     return a->code;
 }
 
+template <typename T>
+void State::journal(const T& entry)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto pos = m_journal.size();
+    m_journal.resize(pos + sizeof(T) + 1);
+    std::memcpy(&m_journal[pos], &entry, sizeof(T));
+    m_journal[pos + sizeof(T)] = static_cast<uint8_t>(T::TAG);
+}
+
+template <typename T>
+T State::pop_journal() noexcept
+{
+    assert(static_cast<JournalTag>(m_journal.back()) == T::TAG);
+    const auto pos = m_journal.size() - 1 - sizeof(T);
+    T entry;
+    std::memcpy(&entry, &m_journal[pos], sizeof(T));
+    m_journal.resize(pos);
+    return entry;
+}
+
 Account& State::touch(const address& addr)
 {
     auto& acc = get_or_insert(addr, {.erase_if_empty = true});
     if (!acc.erase_if_empty && acc.is_empty())
     {
         acc.erase_if_empty = true;
-        m_journal.emplace_back(JournalTouched{addr});
+        journal(JournalTouched{addr});
     }
     return acc;
 }
@@ -319,106 +341,101 @@ StorageValue& State::get_storage(const address& addr, const bytes32& key)
 
 void State::journal_balance_change(const address& addr, const intx::uint256& prev_balance)
 {
-    m_journal.emplace_back(JournalBalanceChange{{addr}, prev_balance});
+    journal(JournalBalanceChange{{addr}, prev_balance});
 }
 
 void State::journal_storage_change(
     const address& addr, const bytes32& key, const StorageValue& value)
 {
-    m_journal.emplace_back(JournalStorageChange{{addr}, key, value.current, value.access_status});
+    journal(JournalStorageChange{{addr}, key, value.current, value.access_status});
 }
 
 void State::journal_transient_storage_change(
     const address& addr, const bytes32& key, const bytes32& value)
 {
-    m_journal.emplace_back(JournalTransientStorageChange{{addr}, key, value});
+    journal(JournalTransientStorageChange{{addr}, key, value});
 }
 
 void State::journal_bump_nonce(const address& addr)
 {
-    m_journal.emplace_back(JournalNonceBump{addr});
+    journal(JournalNonceBump{addr});
 }
 
 void State::journal_create(const address& addr, bool existed)
 {
-    m_journal.emplace_back(JournalCreate{{addr}, existed});
+    journal(JournalCreate{{addr}, existed});
 }
 
 void State::journal_destruct(const address& addr)
 {
-    m_journal.emplace_back(JournalDestruct{addr});
+    journal(JournalDestruct{addr});
 }
 
 void State::journal_access_account(const address& addr)
 {
-    m_journal.emplace_back(JournalAccessAccount{addr});
+    journal(JournalAccessAccount{addr});
 }
 
 void State::rollback(size_t checkpoint)
 {
     while (m_journal.size() != checkpoint)
     {
-        std::visit(
-            [this](const auto& e) {
-                using T = std::decay_t<decltype(e)>;
-                if constexpr (std::is_same_v<T, JournalNonceBump>)
-                {
-                    get(e.addr).nonce -= 1;
-                }
-                else if constexpr (std::is_same_v<T, JournalTouched>)
-                {
-                    get(e.addr).erase_if_empty = false;
-                }
-                else if constexpr (std::is_same_v<T, JournalDestruct>)
-                {
-                    get(e.addr).destructed = false;
-                }
-                else if constexpr (std::is_same_v<T, JournalAccessAccount>)
-                {
-                    get(e.addr).access_status = EVMC_ACCESS_COLD;
-                }
-                else if constexpr (std::is_same_v<T, JournalCreate>)
-                {
-                    if (e.existed)
-                    {
-                        // This account is not always "touched". TODO: Why?
-                        auto& a = get(e.addr);
-                        a.nonce = 0;
-                        a.code_hash = Account::EMPTY_CODE_HASH;
-                        a.code.clear();
-                    }
-                    else
-                    {
-                        // TODO: Before Spurious Dragon we don't clear empty accounts ("erasable")
-                        //       so we need to delete them here explicitly.
-                        //       This should be changed by tuning "erasable" flag
-                        //       and clear in all revisions.
-                        m_modified.erase(e.addr);
-                    }
-                }
-                else if constexpr (std::is_same_v<T, JournalStorageChange>)
-                {
-                    auto& s = get(e.addr).storage.find(e.key)->second;
-                    s.current = e.prev_value;
-                    s.access_status = e.prev_access_status;
-                }
-                else if constexpr (std::is_same_v<T, JournalTransientStorageChange>)
-                {
-                    auto& s = get(e.addr).transient_storage.find(e.key)->second;
-                    s = e.prev_value;
-                }
-                else if constexpr (std::is_same_v<T, JournalBalanceChange>)
-                {
-                    get(e.addr).balance = e.prev_balance;
-                }
-                else
-                {
-                    // TODO(C++23): Change condition to `false` once CWG2518 is in.
-                    static_assert(std::is_void_v<T>, "unhandled journal entry type");
-                }
-            },
-            m_journal.back());
-        m_journal.pop_back();
+        switch (static_cast<JournalTag>(m_journal.back()))
+        {
+        case JournalTag::NonceBump:
+            get(pop_journal<JournalNonceBump>().addr).nonce -= 1;
+            break;
+        case JournalTag::Touched:
+            get(pop_journal<JournalTouched>().addr).erase_if_empty = false;
+            break;
+        case JournalTag::Destruct:
+            get(pop_journal<JournalDestruct>().addr).destructed = false;
+            break;
+        case JournalTag::AccessAccount:
+            get(pop_journal<JournalAccessAccount>().addr).access_status = EVMC_ACCESS_COLD;
+            break;
+        case JournalTag::Create:
+        {
+            const auto e = pop_journal<JournalCreate>();
+            if (e.existed)
+            {
+                // This account is not always "touched". TODO: Why?
+                auto& a = get(e.addr);
+                a.nonce = 0;
+                a.code_hash = Account::EMPTY_CODE_HASH;
+                a.code.clear();
+            }
+            else
+            {
+                // TODO: Before Spurious Dragon we don't clear empty accounts ("erasable")
+                //       so we need to delete them here explicitly.
+                //       This should be changed by tuning "erasable" flag
+                //       and clear in all revisions.
+                m_modified.erase(e.addr);
+            }
+            break;
+        }
+        case JournalTag::StorageChange:
+        {
+            const auto e = pop_journal<JournalStorageChange>();
+            auto& s = get(e.addr).storage.find(e.key)->second;
+            s.current = e.prev_value;
+            s.access_status = e.prev_access_status;
+            break;
+        }
+        case JournalTag::TransientStorageChange:
+        {
+            const auto e = pop_journal<JournalTransientStorageChange>();
+            get(e.addr).transient_storage.find(e.key)->second = e.prev_value;
+            break;
+        }
+        case JournalTag::BalanceChange:
+        {
+            const auto e = pop_journal<JournalBalanceChange>();
+            get(e.addr).balance = e.prev_balance;
+            break;
+        }
+        }
     }
 }
 
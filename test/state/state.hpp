@@ -19,6 +19,19 @@ namespace evmone::state
 /// The Ethereum State: the collection of accounts mapped by their addresses.
 class State
 {
+    /// The type tags of the journal records.
+    enum class JournalTag : uint8_t
+    {
+        BalanceChange,
+        Touched,
+        StorageChange,
+        NonceBump,
+        Create,
+        TransientStorageChange,
+        Destruct,
+        AccessAccount,
+    };
+
     struct JournalBase
     {
         address addr;
@@ -26,14 +39,18 @@ class State
 
     struct JournalBalanceChange : JournalBase
     {
+        static constexpr auto TAG = JournalTag::BalanceChange;
         intx::uint256 prev_balance;
     };
 
     struct JournalTouched : JournalBase
-    {};
+    {
+        static constexpr auto TAG = JournalTag::Touched;
+    };
 
     struct JournalStorageChange : JournalBase
     {
+        static constexpr auto TAG = JournalTag::StorageChange;
         bytes32 key;
         bytes32 prev_value;
         evmc_access_status prev_access_status;
@@ -41,37 +58,52 @@ class State
 
     struct JournalTransientStorageChange : JournalBase
     {
+        static constexpr auto TAG = JournalTag::TransientStorageChange;
         bytes32 key;
         bytes32 prev_value;
     };
 
     struct JournalNonceBump : JournalBase
-    {};
+    {
+        static constexpr auto TAG = JournalTag::NonceBump;
+    };
 
     struct JournalCreate : JournalBase
     {
+        static constexpr auto TAG = JournalTag::Create;
         bool existed;
     };
 
     struct JournalDestruct : JournalBase
-    {};
+    {
+        static constexpr auto TAG = JournalTag::Destruct;
+    };
 
     struct JournalAccessAccount : JournalBase
-    {};
-
-    using JournalEntry =
-        std::variant<JournalBalanceChange, JournalTouched, JournalStorageChange, JournalNonceBump,
-            JournalCreate, JournalTransientStorageChange, JournalDestruct, JournalAccessAccount>;
+    {
+        static constexpr auto TAG = JournalTag::AccessAccount;
+    };
 
     /// The read-only view of the initial (cold) state.
     const StateView& m_initial;
 
     /// The accounts loaded from the initial state and potentially modified.
-    std::unordered_map<address, Account> m_modified;
+    FlatMap<address, Account, AddressHash> m_modified;
 
-    /// The state journal: the list of changes made to the state
+    /// The state journal: the records of changes made to the state
     /// with information how to revert them.
-    std::vector<JournalEntry> m_journal;
+    ///
+    /// Each record is the journal entry followed by its JournalTag byte, so it takes
+    /// only the size of its own entry type and the records are read backwards from the end.
+    std::vector<uint8_t> m_journal;
+
+    /// Appends the journal record of the entry.
+    template <typename T>
+    void journal(const T& entry);
+
+    /// Removes the last journal record and returns its entry. The record must be of the type T.
+    template <typename T>
+    T pop_journal() noexcept;
 
 public:
     explicit State(const StateView& state_view) noexcept : m_initial{state_view} {}
@@ -98,8 +130,8 @@ public:
 
     StateDiff build_diff(evmc_revision rev) const;
 
-    /// Returns the state journal checkpoint. It can be later used to in rollback()
-    /// to revert changes newer than the checkpoint.
+    /// Returns the state journal checkpoint (the journal size in bytes). It can be later used
+    /// in rollback() to revert changes newer than the checkpoint.
     [[nodiscard]] size_t checkpoint() const noexcept { return m_journal.size(); }
 
     /// Reverts state changes made after the checkpoint.
@@ -0,0 +1,279 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "state_snapshot.hpp"
+#include "hash_utils.hpp"
+#include "state.hpp"
+#include "test_state.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#if defined(_WIN32)
+#define EVMONE_STATE_SNAPSHOT_SUPPORTED 0
+#else
+#define EVMONE_STATE_SNAPSHOT_SUPPORTED 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace evmone::test
+{
+namespace
+{
+using Header = StateSnapshot::Header;
+using AccountEntry = StateSnapshot::AccountEntry;
+using StorageEntry = StateSnapshot::StorageEntry;
+using CodeEntry = StateSnapshot::CodeEntry;
+
+static_assert(sizeof(Header) == 40);
+static_assert(sizeof(AccountEntry) == 80);
+static_assert(sizeof(StorageEntry) == 64);
+static_assert(sizeof(CodeEntry) == 48);
+
+/// The offsets of the file sections.
+struct Layout
+{
+    uint64_t accounts = sizeof(Header);
+    uint64_t storage = 0;
+    uint64_t codes = 0;
+    uint64_t code_bytes = 0;
+
+    explicit Layout(const Header& h) noexcept
+      : storage{accounts + h.num_accounts * sizeof(AccountEntry)},
+        codes{storage + h.num_storage_entries * sizeof(StorageEntry)},
+        code_bytes{codes + uint64_t{h.num_codes} * sizeof(CodeEntry)}
+    {}
+};
+
+/// Checks if the header matches the file and the sections fit in it.
+/// The records are checked lazily when accessed, so opening does not read the whole file.
+bool validate(const Header& h, size_t size) noexcept
+{
+    // Limit the counts so that computing the section offsets cannot overflow.
+    constexpr uint64_t max_count = uint64_t{1} << 48;
+    return h.magic == StateSnapshot::MAGIC && h.version == StateSnapshot::VERSION &&
+           h.file_size == size && h.num_accounts < max_count &&
+           h.num_storage_entries < max_count && Layout{h}.code_bytes <= size;
+}
+
+/// Writes the object representation of the records to the file.
+template <typename T>
+bool write_records(std::FILE* f, std::span<const T> records) noexcept
+{
+    return std::fwrite(records.data(), sizeof(T), records.size(), f) == records.size();
+}
+}  // namespace
+
+std::unique_ptr<const StateSnapshot> StateSnapshot::open(const std::string& path)
+{
+#if EVMONE_STATE_SNAPSHOT_SUPPORTED
+    const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+        static_cast<size_t>(st.st_size) < sizeof(Header))
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    const auto size = static_cast<size_t>(st.st_size);
+    auto* const mem = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // The mapping stays valid.
+    if (mem == MAP_FAILED)
+        return nullptr;
+
+    std::unique_ptr<StateSnapshot> snapshot{new StateSnapshot};
+    snapshot->m_data = static_cast<const uint8_t*>(mem);
+    snapshot->m_size = size;
+
+    Header header;
+    std::memcpy(&header, snapshot->m_data, sizeof(header));
+    if (!validate(header, size))
+        return nullptr;
+
+    const Layout layout{header};
+    snapshot->m_accounts = {
+        reinterpret_cast<const AccountEntry*>(&snapshot->m_data[layout.accounts]),
+        header.num_accounts};
+    snapshot->m_storage = {
+        reinterpret_cast<const StorageEntry*>(&snapshot->m_data[layout.storage]),
+        header.num_storage_entries};
+    snapshot->m_codes = {
+        reinterpret_cast<const CodeEntry*>(&snapshot->m_data[layout.codes]), header.num_codes};
+    return snapshot;
+#else
+    (void)path;
+    return nullptr;
+#endif
+}
+
+StateSnapshot::~StateSnapshot()
+{
+#if EVMONE_STATE_SNAPSHOT_SUPPORTED
+    if (m_data != nullptr)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
+
+bool StateSnapshot::write(const std::string& path, const TestState& state)
+{
+    // Deduplicate the codes. The map orders them by the code hash.
+    // The code index of each account is its ordinal in the map, assigned once all codes are in.
+    std::map<evmc::bytes32, std::pair<const bytes*, uint32_t>> codes;
+    std::vector<decltype(codes)::iterator> account_codes;
+    account_codes.reserve(state.size());
+    for (const auto& [_, acc] : state)
+    {
+        account_codes.push_back(
+            !acc.code.empty() ? codes.try_emplace(keccak256(acc.code), &acc.code, 0).first :
+                                codes.end());
+    }
+    uint32_t code_index = 0;
+    for (auto& [_, code] : codes)
+        code.second = code_index++;
+
+    Header header{
+        .num_codes = static_cast<uint32_t>(codes.size()),
+        .num_accounts = state.size(),
+    };
+    for (const auto& [_, acc] : state)
+        header.num_storage_entries += acc.storage.size();
+    const Layout layout{header};
+
+    std::vector<CodeEntry> code_entries;
+    code_entries.reserve(codes.size());
+    auto code_offset = layout.code_bytes;
+    for (const auto& [code_hash, code] : codes)
+    {
+        code_entries.push_back({code_hash, code_offset, code.first->size()});
+        code_offset += code.first->size();
+    }
+    header.file_size = code_offset;
+
+    // The TestState is ordered by the address and its storage by the key.
+    std::vector<AccountEntry> accounts;
+    accounts.reserve(state.size());
+    uint64_t storage_index = 0;
+    auto account_code = account_codes.begin();
+    for (const auto& [addr, acc] : state)
+    {
+        auto& e = accounts.emplace_back();
+        e.addr = addr;
+        e.nonce = acc.nonce;
+        e.balance = intx::be::store<evmc::bytes32>(acc.balance);
+        if (const auto it = *account_code++; it != codes.end())
+            e.code_index = it->second.second;
+        e.storage_begin = storage_index;
+        storage_index += acc.storage.size();
+        e.storage_end = storage_index;
+    }
+
+#if EVMONE_STATE_SNAPSHOT_SUPPORTED
+    // Write to the unique temporary file and rename it so that other processes never see
+    // the partially written file and the existing mappings of the old file stay valid.
+    auto tmp_path = path + ".XXXXXX";
+    const auto fd = mkstemp(tmp_path.data());
+    if (fd < 0)
+        return false;
+    auto* const f = fdopen(fd, "wb");
+    if (f == nullptr)
+    {
+        close(fd);
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+
+    bool written = std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+                   write_records<AccountEntry>(f, accounts);
+    for (auto it = state.begin(); written && it != state.end(); ++it)
+    {
+        for (const auto& [key, value] : it->second.storage)
+        {
+            const StorageEntry entry{key, value};
+            written = written && std::fwrite(&entry, sizeof(entry), 1, f) == 1;
+        }
+    }
+    written = written && write_records<CodeEntry>(f, code_entries);
+    for (const auto& [_, code] : codes)
+    {
+        const auto& c = *code.first;
+        written = written && std::fwrite(c.data(), 1, c.size(), f) == c.size();
+    }
+
+    if (std::fclose(f) != 0 || !written || std::rename(tmp_path.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+const StateSnapshot::AccountEntry* StateSnapshot::find(const evmc::address& addr) const noexcept
+{
+    const auto it = std::ranges::lower_bound(m_accounts, addr, {}, &AccountEntry::addr);
+    return it != m_accounts.end() && it->addr == addr ? &*it : nullptr;
+}
+
+const StateSnapshot::CodeEntry* StateSnapshot::find_code(const AccountEntry& account) const noexcept
+{
+    if (account.code_index >= m_codes.size())
+        return nullptr;
+    const auto& code = m_codes[account.code_index];
+    if (code.offset > m_size || code.size > m_size - code.offset)
+        return nullptr;  // Invalid record.
+    return &code;
+}
+
+std::optional<state::StateView::Account> StateSnapshot::get_account(
+    const evmc::address& addr) const noexcept
+{
+    const auto* const acc = find(addr);
+    if (acc == nullptr)
+        return std::nullopt;
+
+    const auto* const code = find_code(*acc);
+    return Account{
+        .nonce = acc->nonce,
+        .balance = intx::be::load<intx::uint256>(acc->balance),
+        .code_hash = code != nullptr ? code->code_hash : state::Account::EMPTY_CODE_HASH,
+        .has_storage = acc->storage_begin < acc->storage_end,
+    };
+}
+
+evmc::bytes StateSnapshot::get_account_code(const evmc::address& addr) const noexcept
+{
+    const auto* const acc = find(addr);
+    if (acc == nullptr)
+        return {};
+    const auto* const code = find_code(*acc);
+    if (code == nullptr)
+        return {};
+    return {&m_data[code->offset], code->size};
+}
+
+evmc::bytes32 StateSnapshot::get_storage(
+    const evmc::address& addr, const evmc::bytes32& key) const noexcept
+{
+    const auto* const acc = find(addr);
+    if (acc == nullptr || acc->storage_begin > acc->storage_end ||
+        acc->storage_end > m_storage.size())
+        return {};
+
+    const auto storage =
+        m_storage.subspan(acc->storage_begin, acc->storage_end - acc->storage_begin);
+    const auto it = std::ranges::lower_bound(storage, key, {}, &StorageEntry::key);
+    return it != storage.end() && it->key == key ? it->value : evmc::bytes32{};
+}
+}  // namespace evmone::test
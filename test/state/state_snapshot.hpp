@@ -0,0 +1,116 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "state_view.hpp"
+#include <evmc/evmc.hpp>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace evmone::test
+{
+class TestState;
+
+/// The state backed by the memory-mapped binary snapshot file.
+///
+/// The file is used in place without parsing, so opening the snapshot of any size is instant
+/// and the pages of the file are shared by the page cache between processes.
+/// The file layout:
+/// - the Header,
+/// - the AccountEntry array sorted by the address,
+/// - the StorageEntry array: the storage entries of each account sorted by the key,
+/// - the CodeEntry array of the deduplicated codes sorted by the code hash,
+/// - the code bytes.
+/// The accounts and the storage entries are looked up by binary search.
+class StateSnapshot : public state::StateView
+{
+public:
+    /// The file magic number: "evmoneSS" in little-endian.
+    static constexpr uint64_t MAGIC = 0x5353656e6f6d7665;
+
+    /// The file format version.
+    static constexpr uint32_t VERSION = 1;
+
+    /// The code index of the accounts without code.
+    static constexpr uint32_t NO_CODE = 0xffffffff;
+
+    /// The file header.
+    struct Header
+    {
+        uint64_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint32_t num_codes = 0;  ///< The number of the CodeEntry records.
+        uint64_t num_accounts = 0;
+        uint64_t num_storage_entries = 0;
+        uint64_t file_size = 0;
+    };
+
+    /// The account record.
+    struct AccountEntry
+    {
+        evmc::address addr;
+        uint32_t code_index = NO_CODE;  ///< The index of the CodeEntry or NO_CODE.
+        uint64_t nonce = 0;
+        evmc::bytes32 balance;      ///< The balance in big-endian.
+        uint64_t storage_begin = 0;  ///< The index of the first storage entry.
+        uint64_t storage_end = 0;    ///< The index after the last storage entry.
+    };
+
+    /// The storage entry.
+    struct StorageEntry
+    {
+        evmc::bytes32 key;
+        evmc::bytes32 value;
+    };
+
+    /// The code record.
+    struct CodeEntry
+    {
+        evmc::bytes32 code_hash;
+        uint64_t offset = 0;  ///< The offset of the code in the file.
+        uint64_t size = 0;
+    };
+
+private:
+    /// The memory-mapped file contents.
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+
+    std::span<const AccountEntry> m_accounts;
+    std::span<const StorageEntry> m_storage;
+    std::span<const CodeEntry> m_codes;
+
+    StateSnapshot() noexcept = default;
+
+    /// Finds the account record. Returns null if not found.
+    [[nodiscard]] const AccountEntry* find(const evmc::address& addr) const noexcept;
+
+    /// Returns the code record of the account. Returns null if the account has no code.
+    [[nodiscard]] const CodeEntry* find_code(const AccountEntry& account) const noexcept;
+
+public:
+    StateSnapshot(const StateSnapshot&) = delete;
+    StateSnapshot& operator=(const StateSnapshot&) = delete;
+    ~StateSnapshot() override;
+
+    /// Opens and memory-maps the snapshot file.
+    /// Returns null if the file cannot be mapped or is not a valid snapshot.
+    static std::unique_ptr<const StateSnapshot> open(const std::string& path);
+
+    /// Writes the state to the snapshot file. The file is replaced atomically.
+    /// Returns false on failure.
+    static bool write(const std::string& path, const TestState& state);
+
+    [[nodiscard]] size_t num_accounts() const noexcept { return m_accounts.size(); }
+
+    [[nodiscard]] size_t num_codes() const noexcept { return m_codes.size(); }
+
+    std::optional<Account> get_account(const evmc::address& addr) const noexcept override;
+    evmc::bytes get_account_code(const evmc::address& addr) const noexcept override;
+    evmc::bytes32 get_storage(
+        const evmc::address& addr, const evmc::bytes32& key) const noexcept override;
+};
+}  // namespace evmone::test
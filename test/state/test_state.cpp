@@ -4,6 +4,7 @@
 #include "test_state.hpp"
 #include "state.hpp"
 #include "system_contracts.hpp"
+#include <algorithm>
 
 namespace evmone::test
 {
@@ -59,6 +60,166 @@ bytes32 TestState::get_storage(const address& addr, const bytes32& key) const no
     return (it != storage.end()) ? it->second : bytes32{};
 }
 
+const TestAccount* TestStateOverlay::find_base(
+    const address& addr, const AccountChange& change) const noexcept
+{
+    if (change.recreated)
+        return nullptr;
+    const auto it = m_base.find(addr);
+    return it != m_base.end() ? &it->second : nullptr;
+}
+
+std::optional<state::StateView::Account> TestStateOverlay::get_account(
+    const address& addr) const noexcept
+{
+    const auto it = m_changes.find(addr);
+    if (it == m_changes.end())
+        return m_base.get_account(addr);
+    if (!it->second.has_value())
+        return std::nullopt;
+
+    const auto& change = *it->second;
+    const auto* const base = find_base(addr, change);
+
+    bool has_storage = std::ranges::any_of(
+        change.storage, [](const auto& entry) { return !is_zero(entry.second); });
+    if (!has_storage && base != nullptr)
+    {
+        // The base storage entries are visible unless deleted in the layer.
+        has_storage = std::ranges::any_of(base->storage,
+            [&change](const auto& entry) { return !change.storage.contains(entry.first); });
+    }
+
+    const auto code_hash = change.code.has_value() ? keccak256(*change.code) :
+                           base != nullptr         ? keccak256(base->code) :
+                                                     state::Account::EMPTY_CODE_HASH;
+    return Account{change.nonce, change.balance, code_hash, has_storage};
+}
+
+bytes TestStateOverlay::get_account_code(const address& addr) const noexcept
+{
+    const auto it = m_changes.find(addr);
+    if (it == m_changes.end())
+        return m_base.get_account_code(addr);
+    if (!it->second.has_value())
+        return {};
+
+    const auto& change = *it->second;
+    if (change.code.has_value())
+        return *change.code;
+    const auto* const base = find_base(addr, change);
+    return base != nullptr ? base->code : bytes{};
+}
+
+bytes32 TestStateOverlay::get_storage(const address& addr, const bytes32& key) const noexcept
+{
+    const auto it = m_changes.find(addr);
+    if (it == m_changes.end())
+        return m_base.get_storage(addr, key);
+    if (!it->second.has_value())
+        return bytes32{};
+
+    const auto& change = *it->second;
+    if (const auto sit = change.storage.find(key); sit != change.storage.end())
+        return sit->second;
+    return change.recreated ? bytes32{} : m_base.get_storage(addr, key);
+}
+
+void TestStateOverlay::apply(const state::StateDiff& diff)
+{
+    for (const auto& m : diff.modified_accounts)
+    {
+        const auto [it, inserted] = m_changes.try_emplace(m.addr);
+        auto& change = it->second;
+        if (!change.has_value())
+        {
+            change.emplace();
+            // The account deleted before in the layer is created again.
+            change->recreated = !inserted;
+        }
+        change->nonce = m.nonce;
+        change->balance = m.balance;
+        if (m.code.has_value())
+            change->code = *m.code;
+        for (const auto& [k, v] : m.modified_storage)
+            change->storage.insert_or_assign(k, v);
+    }
+
+    for (const auto& addr : diff.deleted_accounts)
+        m_changes.insert_or_assign(addr, std::nullopt);
+}
+
+state::StateDiff TestStateOverlay::diff() const
+{
+    state::StateDiff result;
+    for (const auto& [addr, change] : m_changes)
+    {
+        if (!change.has_value())
+        {
+            result.deleted_accounts.emplace_back(addr);
+            continue;
+        }
+
+        auto& m = result.modified_accounts.emplace_back();
+        m.addr = addr;
+        m.nonce = change->nonce;
+        m.balance = change->balance;
+        m.code = change->code;
+        if (change->recreated)
+        {
+            // Clear the code and the storage of the account in the base state.
+            if (!m.code.has_value())
+                m.code.emplace();
+            if (const auto it = m_base.find(addr); it != m_base.end())
+            {
+                for (const auto& [k, _] : it->second.storage)
+                {
+                    if (!change->storage.contains(k))
+                        m.modified_storage.emplace_back(k, bytes32{});
+                }
+            }
+        }
+        m.modified_storage.insert(
+            m.modified_storage.end(), change->storage.begin(), change->storage.end());
+    }
+    return result;
+}
+
+void TestStateOverlay::for_each_account(
+    const std::function<void(const address&, const TestAccount&)>& fn) const
+{
+    auto base_it = m_base.begin();
+    for (const auto& [addr, change] : m_changes)
+    {
+        for (; base_it != m_base.end() && base_it->first < addr; ++base_it)
+            fn(base_it->first, base_it->second);
+        if (base_it != m_base.end() && base_it->first == addr)
+            ++base_it;
+
+        if (!change.has_value())
+            continue;
+
+        TestAccount acc{.nonce = change->nonce, .balance = change->balance};
+        if (const auto* const base = find_base(addr, *change); base != nullptr)
+        {
+            acc.storage = base->storage;
+            acc.code = base->code;
+        }
+        if (change->code.has_value())
+            acc.code = *change->code;
+        for (const auto& [k, v] : change->storage)
+        {
+            if (v)
+                acc.storage.insert_or_assign(k, v);
+            else
+                acc.storage.erase(k);
+        }
+        fn(addr, acc);
+    }
+    for (; base_it != m_base.end(); ++base_it)
+        fn(base_it->first, base_it->second);
+}
+
 bytes32 TestBlockHashes::get_block_hash(int64_t block_number) const noexcept
 {
     if (const auto& it = find(block_number); it != end())
@@ -70,8 +231,8 @@ bytes32 TestBlockHashes::get_block_hash(int64_t block_number) const noexcept
     return keccak256({reinterpret_cast<const uint8_t*>(s.data()), s.size()});
 }
 
-[[nodiscard]] std::variant<state::TransactionReceipt, std::error_code> transition(TestState& state,
-    const state::BlockInfo& block, const state::BlockHashes& block_hashes,
+[[nodiscard]] std::variant<state::TransactionReceipt, std::error_code> transition(
+    WritableStateView& state, const state::BlockInfo& block, const state::BlockHashes& block_hashes,
     const state::Transaction& tx, evmc_revision rev, evmc::VM& vm, int64_t block_gas_left,
     int64_t blob_gas_left)
 {
@@ -86,7 +247,7 @@ bytes32 TestBlockHashes::get_block_hash(int64_t block_number) const noexcept
     return receipt;
 }
 
-void finalize(TestState& state, evmc_revision rev, const address& coinbase,
+void finalize(WritableStateView& state, evmc_revision rev, const address& coinbase,
     std::optional<uint64_t> block_reward, std::span<const state::Ommer> ommers,
     std::span<const state::Withdrawal> withdrawals)
 {
@@ -94,15 +255,16 @@ void finalize(TestState& state, evmc_revision rev, const address& coinbase,
     state.apply(diff);
 }
 
-void system_call_block_start(TestState& state, const state::BlockInfo& block,
+void system_call_block_start(WritableStateView& state, const state::BlockInfo& block,
     const state::BlockHashes& block_hashes, evmc_revision rev, evmc::VM& vm)
 {
     const auto diff = state::system_call_block_start(state, block, block_hashes, rev, vm);
     state.apply(diff);
 }
 
-std::vector<state::Requests> system_call_block_end(TestState& state, const state::BlockInfo& block,
-    const state::BlockHashes& block_hashes, evmc_revision rev, evmc::VM& vm)
+std::vector<state::Requests> system_call_block_end(WritableStateView& state,
+    const state::BlockInfo& block, const state::BlockHashes& block_hashes, evmc_revision rev,
+    evmc::VM& vm)
 {
     const auto [diff, requests] = state::system_call_block_end(state, block, block_hashes, rev, vm);
     state.apply(diff);
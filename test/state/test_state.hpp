@@ -6,6 +6,7 @@
 #include "state_view.hpp"
 #include <evmc/evmc.hpp>
 #include <intx/intx.hpp>
+#include <functional>
 #include <map>
 #include <span>
 #include <variant>
@@ -41,12 +42,20 @@ struct TestAccount
     bool operator==(const TestAccount&) const noexcept = default;
 };
 
+/// The state view which the state changes can be applied to.
+class WritableStateView : public state::StateView
+{
+public:
+    /// Apply the state changes.
+    virtual void apply(const state::StateDiff& diff) = 0;
+};
+
 /// Ethereum State representation for tests.
 ///
 /// This is a simplified variant of state::State:
 /// it hides some details related to transaction execution (e.g. original storage values)
 /// and is also easier to work with in tests.
-class TestState : public state::StateView, public std::map<address, TestAccount>
+class TestState : public WritableStateView, public std::map<address, TestAccount>
 {
 public:
     using map::map;
@@ -69,8 +78,60 @@ public:
     /// TODO: deprecate this method.
     TestAccount& get(const address& addr) { return (*this)[addr]; }
 
-    /// Apply the state changes.
-    void apply(const state::StateDiff& diff);
+    void apply(const state::StateDiff& diff) override;
+};
+
+/// The copy-on-write layer over the TestState.
+///
+/// The layer keeps only the accounts modified by the applied state changes
+/// and reads the other ones from the base state. Creating the layer for a test case or a block
+/// is free and applying the changes costs O(modified) instead of copying the whole state.
+/// The base state must outlive the layer and must not be modified while the layer is in use.
+class TestStateOverlay : public WritableStateView
+{
+    /// The account modified in the layer.
+    struct AccountChange
+    {
+        uint64_t nonce = 0;
+        uint256 balance;
+
+        /// The modified code. The base account code if not set.
+        std::optional<bytes> code;
+
+        /// The modified storage entries. The value 0 means the entry is deleted.
+        std::map<bytes32, bytes32> storage;
+
+        /// The account has been deleted and created again in the layer:
+        /// the storage and the code of the base account are not visible.
+        bool recreated = false;
+    };
+
+    const TestState& m_base;
+
+    /// The accounts modified in the layer. The deleted accounts are nullopt.
+    std::map<address, std::optional<AccountChange>> m_changes;
+
+    /// Returns the base account if visible for the modified account.
+    const TestAccount* find_base(const address& addr, const AccountChange& change) const noexcept;
+
+public:
+    explicit TestStateOverlay(const TestState& base) noexcept : m_base{base} {}
+
+    std::optional<Account> get_account(const address& addr) const noexcept override;
+    bytes get_account_code(const address& addr) const noexcept override;
+    bytes32 get_storage(const address& addr, const bytes32& key) const noexcept override;
+
+    void apply(const state::StateDiff& diff) override;
+
+    /// Returns the changes of the layer relative to the base state.
+    ///
+    /// Applying them to the base state gives the state of the layer.
+    [[nodiscard]] state::StateDiff diff() const;
+
+    /// Calls the function for each account of the layered state in the address order.
+    ///
+    /// The modified accounts are merged with the base accounts into temporary objects.
+    void for_each_account(const std::function<void(const address&, const TestAccount&)>& fn) const;
 };
 
 class TestBlockHashes : public state::BlockHashes, public std::unordered_map<int64_t, bytes32>
@@ -81,23 +142,24 @@ public:
     bytes32 get_block_hash(int64_t block_number) const noexcept override;
 };
 
-/// Wrapping of state::transition() which operates on TestState.
-[[nodiscard]] std::variant<state::TransactionReceipt, std::error_code> transition(TestState& state,
-    const state::BlockInfo& block, const state::BlockHashes& block_hashes,
+/// Wrapping of state::transition() which operates on WritableStateView.
+[[nodiscard]] std::variant<state::TransactionReceipt, std::error_code> transition(
+    WritableStateView& state, const state::BlockInfo& block, const state::BlockHashes& block_hashes,
     const state::Transaction& tx, evmc_revision rev, evmc::VM& vm, int64_t block_gas_left,
     int64_t blob_gas_left);
 
-/// Wrapping of state::finalize() which operates on TestState.
-void finalize(TestState& state, evmc_revision rev, const address& coinbase,
+/// Wrapping of state::finalize() which operates on WritableStateView.
+void finalize(WritableStateView& state, evmc_revision rev, const address& coinbase,
     std::optional<uint64_t> block_reward, std::span<const state::Ommer> ommers,
     std::span<const state::Withdrawal> withdrawals);
 
-/// Wrapping of state::system_call_block_start() which operates on TestState.
-void system_call_block_start(TestState& state, const state::BlockInfo& block,
+/// Wrapping of state::system_call_block_start() which operates on WritableStateView.
+void system_call_block_start(WritableStateView& state, const state::BlockInfo& block,
     const state::BlockHashes& block_hashes, evmc_revision rev, evmc::VM& vm);
 
-/// Wrapping of state::system_call_block_end() which operates on TestState.
-std::vector<state::Requests> system_call_block_end(TestState& state, const state::BlockInfo& block,
-    const state::BlockHashes& block_hashes, evmc_revision rev, evmc::VM& vm);
+/// Wrapping of state::system_call_block_end() which operates on WritableStateView.
+std::vector<state::Requests> system_call_block_end(WritableStateView& state,
+    const state::BlockInfo& block, const state::BlockHashes& block_hashes, evmc_revision rev,
+    evmc::VM& vm);
 }  // namespace test
 }  // namespace evmone
@@ -0,0 +1,208 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// Checks that the warm message calls do not allocate by counting the allocations
+/// with the replaced global operator new. The results are made with the C allocator
+/// (evmc::make_result()) unless the output is leased from the frame arena,
+/// so the release function of the nested call results is checked too.
+
+#include "test/utils/bytecode.hpp"
+#include <evmc/evmc.hpp>
+#include <evmc/mocked_host.hpp>
+#include <evmone/evmone.h>
+#include <evmone/execution_state.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer)
+#define EVMONE_SANITIZED_ALLOCATIONS 1
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+#define EVMONE_SANITIZED_ALLOCATIONS 1
+#endif
+
+namespace
+{
+/// Are the allocations counted?
+bool counting = false;
+
+/// The number of the counted allocations.
+size_t num_allocations = 0;
+
+#ifndef EVMONE_SANITIZED_ALLOCATIONS
+void* allocate(std::size_t size)
+{
+    if (counting)
+        ++num_allocations;
+    if (auto* const p = std::malloc(size != 0 ? size : 1); p != nullptr)
+        return p;
+    throw std::bad_alloc{};
+}
+
+void* allocate_aligned(std::size_t size, std::align_val_t align)
+{
+    if (counting)
+        ++num_allocations;
+    const auto alignment = static_cast<std::size_t>(align);
+    // The size of the std::aligned_alloc() must be a multiple of the alignment.
+    const auto aligned_size = (std::max(size, std::size_t{1}) + alignment - 1) & ~(alignment - 1);
+#if defined(_WIN32)
+    auto* const p = _aligned_malloc(aligned_size, alignment);
+#else
+    auto* const p = std::aligned_alloc(alignment, aligned_size);
+#endif
+    if (p != nullptr)
+        return p;
+    throw std::bad_alloc{};
+}
+
+void free_aligned(void* p) noexcept
+{
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+#endif
+
+/// Returns the release function of the results with the output leased from the frame arena.
+evmc_release_result_fn arena_release() noexcept
+{
+    evmone::FrameArena arena;
+    auto* const output = arena.allocate_output(1);
+    const auto result = arena.lease_output(EVMC_SUCCESS, 0, 0, output, 1);
+    result.release(&result);
+    return result.release;
+}
+}  // namespace
+
+// The sanitizers replace the operator new themselves and check the pairing with delete.
+#ifndef EVMONE_SANITIZED_ALLOCATIONS
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    return allocate_aligned(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+    return allocate_aligned(size, align);
+}
+
+void operator delete(void* p, std::align_val_t /*align*/) noexcept
+{
+    free_aligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t /*align*/) noexcept
+{
+    free_aligned(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/, std::align_val_t /*align*/) noexcept
+{
+    free_aligned(p);
+}
+
+void operator delete[](void* p, std::size_t /*size*/, std::align_val_t /*align*/) noexcept
+{
+    free_aligned(p);
+}
+#endif
+
+TEST(allocation, warm_call)
+{
+#ifdef EVMONE_SANITIZED_ALLOCATIONS
+    GTEST_SKIP() << "the allocations are not counted with sanitizers";
+#endif
+    using namespace evmone::test;
+
+    /// The host executing the nested calls in the VM.
+    class NestedHost : public evmc::MockedHost
+    {
+    public:
+        evmc::VM* vm = nullptr;
+        bytecode callee_code;
+
+        /// The release function of the last nested call result.
+        evmc_release_result_fn last_release = nullptr;
+
+        evmc::Result call(const evmc_message& msg) noexcept override
+        {
+            const auto result =
+                vm->execute(*this, EVMC_CANCUN, msg, callee_code.data(), callee_code.size())
+                    .release_raw();
+            last_release = result.release;
+            return evmc::Result{result};
+        }
+    };
+
+    // The caller makes the calls with the output and copies the return data.
+    const auto callee_code = mstore(0, add(calldataload(0), 1)) + ret(0, 32);
+    const auto code = 4 * (mstore(0, 1) + call(0).gas(0xffff).input(0, 32).output(32, 32) +
+                              OP_POP + returndatacopy(64, 0, 32)) +
+                      OP_STOP;
+
+    evmc::VM vm{evmc_create_evmone(), {{"analysis_cache", "1"}}};
+    NestedHost host;
+    host.vm = &vm;
+    host.callee_code = callee_code;
+    evmc_message msg{};
+    msg.gas = 1000000;
+
+    // Warm up the execution states, the analysis cache and the host records.
+    for (int i = 0; i < 2; ++i)
+    {
+        const auto r = vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+        ASSERT_EQ(r.status_code, EVMC_SUCCESS);
+    }
+
+    counting = true;
+    const auto r = vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+    counting = false;
+    EXPECT_EQ(r.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(num_allocations, 0);
+
+    // The output of the nested call is not allocated by the C allocator.
+    EXPECT_EQ(host.last_release, arena_release());
+}
@@ -0,0 +1,302 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <evmone/analysis_cache.hpp>
+#include <gtest/gtest.h>
+#include <test/utils/bytecode.hpp>
+#include <filesystem>
+#include <fstream>
+
+using namespace evmone::test;
+using evmone::baseline::AnalysisCache;
+using evmone::baseline::AnalysisCacheFile;
+
+namespace
+{
+/// Returns the unique path of the analysis cache file in the temporary directory.
+std::string temp_cache_file_path()
+{
+    const auto* const test_info = testing::UnitTest::GetInstance()->current_test_info();
+    const auto path = std::filesystem::temp_directory_path() /
+                      (std::string{"evmone_"} + test_info->name() + ".cache");
+    std::filesystem::remove(path);
+    return path.string();
+}
+}  // namespace
+
+TEST(analysis_cache, disabled_by_default)
+{
+    AnalysisCache cache;
+    EXPECT_FALSE(cache.enabled());
+    EXPECT_EQ(cache.max_size(), 0);
+
+    const auto code = push(1) + ret_top();
+    const auto analysis = cache.get(code, false);
+    EXPECT_EQ(analysis->executable_code(), code);
+    EXPECT_EQ(cache.stats().misses, 1);
+    EXPECT_EQ(cache.stats().num_entries, 0);
+    EXPECT_EQ(cache.stats().num_bytes, 0);
+}
+
+TEST(analysis_cache, hit_and_miss)
+{
+    AnalysisCache cache{1024 * 1024};
+    EXPECT_TRUE(cache.enabled());
+
+    const auto code = push(1) + ret_top();
+    const auto a1 = cache.get(code, false);
+    EXPECT_EQ(cache.stats().hits, 0);
+    EXPECT_EQ(cache.stats().misses, 1);
+    EXPECT_EQ(cache.stats().num_entries, 1);
+    EXPECT_GT(cache.stats().num_bytes, code.size());
+
+    const bytes code_copy{code};
+    const auto a2 = cache.get(code_copy, false);
+    EXPECT_EQ(cache.stats().hits, 1);
+    EXPECT_EQ(cache.stats().misses, 1);
+    EXPECT_EQ(a1.get(), a2.get());
+    EXPECT_EQ(a2->executable_code(), code);
+    EXPECT_FALSE(a2->check_jumpdest(0));
+
+    // The same code with the EOF enabled is a different entry.
+    const auto a3 = cache.get(code, true);
+    EXPECT_EQ(cache.stats().misses, 2);
+    EXPECT_EQ(cache.stats().num_entries, 2);
+    EXPECT_NE(a1.get(), a3.get());
+
+    const auto other_code = push(2) + ret_top();
+    const auto a4 = cache.get(other_code, false);
+    EXPECT_EQ(cache.stats().misses, 3);
+    EXPECT_EQ(a4->executable_code(), other_code);
+}
+
+TEST(analysis_cache, eof)
+{
+    AnalysisCache cache{1024 * 1024};
+
+    const auto code = push(1) + ret_top();
+    bytes container = bytecode{eof_bytecode(code, 2).data("da4a")};
+    const auto a1 = cache.get(container, true);
+    EXPECT_EQ(a1->eof_header().version, 1);
+    EXPECT_EQ(a1->executable_code(), code);
+    EXPECT_EQ(a1->raw_code(), container);
+    EXPECT_NE(a1->raw_code().data(), container.data()) << "cache must own the container copy";
+
+    // The cached analysis must not depend on the lifetime of the looked up code.
+    const auto expected_container = container;
+    container.assign(container.size(), 0);
+    EXPECT_EQ(a1->raw_code(), expected_container);
+    EXPECT_EQ(a1->eof_data(), "da4a"_hex);
+
+    const auto a2 = cache.get(expected_container, true);
+    EXPECT_EQ(cache.stats().hits, 1);
+    EXPECT_EQ(a1.get(), a2.get());
+}
+
+TEST(analysis_cache, options)
+{
+    AnalysisCache cache{1024 * 1024};
+
+    const auto code = push(1) + OP_PUSH0 + ret_top();
+    const auto a1 = cache.get(code, false, {.block_checks = true, .rev = EVMC_PARIS});
+    EXPECT_TRUE(a1->has_block_checks(EVMC_PARIS));
+
+    // The block requirements depend on the revision.
+    const auto a2 = cache.get(code, false, {.block_checks = true, .rev = EVMC_SHANGHAI});
+    EXPECT_EQ(cache.stats().misses, 2);
+    EXPECT_NE(a1.get(), a2.get());
+    EXPECT_TRUE(a2->has_block_checks(EVMC_SHANGHAI));
+
+    const auto a3 = cache.get(code, false, {.superinstructions = true});
+    EXPECT_EQ(cache.stats().misses, 3);
+    EXPECT_TRUE(a3->has_superinstructions());
+    EXPECT_FALSE(a3->has_block_checks(EVMC_FRONTIER));
+
+    const auto a4 = cache.get(code, false, {.block_checks = true, .rev = EVMC_PARIS});
+    EXPECT_EQ(cache.stats().hits, 1);
+    EXPECT_EQ(a4.get(), a1.get());
+}
+
+TEST(analysis_cache, insert_if_absent)
+{
+    AnalysisCache cache{1024 * 1024};
+
+    const auto code = push(1) + ret_top();
+    EXPECT_EQ(cache.find(code, false), nullptr);
+
+    // Two analyses of the same code are made concurrently; the first one inserted is kept.
+    auto e1 = cache.make_entry(code, false);
+    auto e2 = cache.make_entry(code, false);
+    EXPECT_EQ(cache.stats().misses, 2);
+    EXPECT_EQ(cache.stats().num_entries, 0);
+
+    const auto a1 = cache.insert(std::move(e1));
+    const auto a2 = cache.insert(std::move(e2));
+    EXPECT_EQ(a1.get(), a2.get());
+    EXPECT_EQ(cache.stats().num_entries, 1);
+
+    const auto a3 = cache.find(code, false);
+    EXPECT_EQ(a3.get(), a1.get());
+    EXPECT_EQ(cache.stats().hits, 1);
+}
+
+TEST(analysis_cache, eviction)
+{
+    const auto code1 = bytecode{OP_JUMPDEST} + 1000 * bytecode{OP_STOP};
+    const auto code2 = bytecode{OP_STOP} + 1000 * bytecode{OP_JUMPDEST};
+    const auto code3 = 2 * OP_JUMPDEST + 999 * bytecode{OP_STOP};
+
+    AnalysisCache cache{1024 * 1024};
+    cache.get(code1, false);
+    const auto entry_size = cache.stats().num_bytes;
+    cache.clear();
+
+    // Fits only 2 entries.
+    cache.set_max_size(entry_size * 2 + entry_size / 2);
+    const auto a1 = cache.get(code1, false);
+    cache.get(code2, false);
+    cache.get(code1, false);  // Mark code1 as the most recently used.
+    EXPECT_EQ(cache.stats().hits, 1);
+    EXPECT_EQ(cache.stats().num_entries, 2);
+
+    cache.get(code3, false);  // Evicts code2.
+    EXPECT_EQ(cache.stats().evictions, 1);
+    EXPECT_EQ(cache.stats().num_entries, 2);
+    EXPECT_EQ(cache.stats().num_bytes, 2 * entry_size);
+
+    cache.get(code1, false);
+    EXPECT_EQ(cache.stats().hits, 2);
+    cache.get(code2, false);
+    EXPECT_EQ(cache.stats().misses, 5);
+    EXPECT_EQ(cache.stats().evictions, 2);
+
+    // Shrinking evicts all entries but the analysis in use stays valid.
+    cache.set_max_size(1);
+    EXPECT_EQ(cache.stats().num_entries, 0);
+    EXPECT_EQ(cache.stats().num_bytes, 0);
+    EXPECT_EQ(cache.stats().evictions, 4);
+    EXPECT_EQ(a1->executable_code(), code1);
+    EXPECT_TRUE(a1->check_jumpdest(0));
+    EXPECT_FALSE(a1->check_jumpdest(1));
+
+    // Entries larger than the cache are not inserted.
+    cache.get(code1, false);
+    EXPECT_EQ(cache.stats().num_entries, 0);
+    EXPECT_EQ(cache.stats().misses, 6);
+}
+
+TEST(analysis_cache, file)
+{
+    const auto path = temp_cache_file_path();
+    const auto code1 = push(1) + OP_JUMPDEST + ret_top();
+    const auto code2 = push(0x5b) + OP_JUMPDEST + OP_PUSH32;
+    const auto eof_code = bytecode{eof_bytecode(push(1) + ret_top(), 2)};
+
+    {
+        AnalysisCache cache{1024 * 1024};
+        EXPECT_FALSE(cache.save_file());
+        ASSERT_TRUE(cache.open_file(path));
+        EXPECT_TRUE(cache.file()->entries().empty());
+        cache.get(code1, false);
+        cache.get(code2, false, {.superinstructions = true});
+        cache.get(code1, false, {.block_checks = true, .rev = EVMC_CANCUN});  // Not persisted.
+        cache.get(eof_code, true);                                          // Not persisted.
+        EXPECT_EQ(cache.stats().file_hits, 0);
+        ASSERT_TRUE(cache.save_file());
+    }
+
+    // The file-backed cache works also with the in-memory cache disabled.
+    AnalysisCache cache;
+    ASSERT_TRUE(cache.open_file(path));
+    EXPECT_TRUE(cache.enabled());
+    ASSERT_EQ(cache.file()->entries().size(), 2);
+
+    const auto a1 = cache.get(code1, false);
+    EXPECT_EQ(cache.stats().file_hits, 1);
+    EXPECT_EQ(a1->executable_code(), code1);
+    const auto code1_hash = AnalysisCacheFile::hash(code1);
+    EXPECT_EQ(a1->raw_code().data(), cache.file()->find(code1, code1_hash, false))
+        << "analysis must be used in place";
+    EXPECT_FALSE(a1->check_jumpdest(0));
+    EXPECT_TRUE(a1->check_jumpdest(2));
+    EXPECT_EQ(a1->executable_code().data()[code1.size()], OP_STOP);
+
+    // The analyses with and without superinstructions are different entries.
+    const auto a2 = cache.get(code2, false);
+    EXPECT_EQ(cache.stats().file_hits, 1);
+    EXPECT_FALSE(a2->has_superinstructions());
+    const auto a3 = cache.get(code2, false, {.superinstructions = true});
+    EXPECT_EQ(cache.stats().file_hits, 2);
+    EXPECT_TRUE(a3->has_superinstructions());
+    EXPECT_EQ(a3->raw_code(), code2);
+    EXPECT_FALSE(a3->check_jumpdest(1));
+    EXPECT_TRUE(a3->check_jumpdest(2));
+
+    cache.get(code1, false, {.block_checks = true, .rev = EVMC_CANCUN});
+    cache.get(eof_code, true);
+    EXPECT_EQ(cache.stats().file_hits, 2);
+
+    // The persistent analyses are kept despite the size limit 0.
+    EXPECT_EQ(cache.stats().num_entries, 0);
+    EXPECT_EQ(cache.stats().num_file_entries, 3);
+    EXPECT_EQ(cache.get(code1, false), a1);
+    EXPECT_EQ(cache.get(code2, false), a2);
+    EXPECT_EQ(cache.stats().hits, 2);
+    EXPECT_EQ(cache.stats().file_hits, 2);
+
+    // The analysis of code2 without superinstructions is missing in the file so it is saved.
+    ASSERT_TRUE(cache.save_file());
+    {
+        AnalysisCache cache2;
+        ASSERT_TRUE(cache2.open_file(path));
+        EXPECT_EQ(cache2.file()->entries().size(), 3);
+        EXPECT_FALSE(cache2.get(code2, false)->has_superinstructions());
+        EXPECT_EQ(cache2.stats().file_hits, 1);
+    }
+
+    // Nothing new to persist so the file is not rewritten.
+    std::filesystem::remove(path);
+    EXPECT_TRUE(cache.save_file());
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(analysis_cache, file_invalid)
+{
+    const auto path = temp_cache_file_path();
+    const auto code = push(1) + OP_JUMPDEST + ret_top();
+    {
+        AnalysisCache cache{1024 * 1024};
+        ASSERT_TRUE(cache.open_file(path));
+        cache.get(code, false);
+        ASSERT_TRUE(cache.save_file());
+    }
+
+    // Corrupt the last byte of the file.
+    const auto file_size = std::filesystem::file_size(path);
+    {
+        std::fstream f{path, std::ios::in | std::ios::out | std::ios::binary};
+        f.seekp(static_cast<std::streamoff>(file_size - 1));
+        f.put('\x01');
+    }
+
+    // The file contents are ignored.
+    AnalysisCache cache{1024 * 1024};
+    ASSERT_TRUE(cache.open_file(path));
+    EXPECT_TRUE(cache.file()->entries().empty());
+    const auto a = cache.get(code, false);
+    EXPECT_EQ(cache.stats().file_hits, 0);
+    EXPECT_EQ(a->executable_code(), code);
+
+    // The file is replaced with the valid one.
+    ASSERT_TRUE(cache.save_file());
+    AnalysisCache cache2;
+    ASSERT_TRUE(cache2.open_file(path));
+    EXPECT_EQ(cache2.file()->entries().size(), 1);
+
+    // The directory cannot be used as the file.
+    EXPECT_FALSE(cache2.open_file(std::filesystem::temp_directory_path().string()));
+    EXPECT_EQ(cache2.file()->entries().size(), 1);
+
+    std::filesystem::remove(path);
+}
@@ -94,6 +94,9 @@ TEST(analysis, jump1)
     EXPECT_EQ(find_jumpdest(analysis, 6), 5);
     EXPECT_EQ(find_jumpdest(analysis, 0), -1);
     EXPECT_EQ(find_jumpdest(analysis, 7), -1);
+    EXPECT_EQ(find_jumpdest(analysis, -1), -1);
+    EXPECT_EQ(find_jumpdest(analysis, static_cast<int>(code.size())), -1);
+    EXPECT_EQ(analysis.jumpdest_bitmap.size(), 1);
 }
 
 TEST(analysis, empty)
@@ -253,6 +256,39 @@ TEST(analysis, jumpdests_groups)
     EXPECT_EQ(analysis.jumpdest_targets[4], 6);
     EXPECT_EQ(analysis.jumpdest_offsets[5], 7);
     EXPECT_EQ(analysis.jumpdest_targets[5], 7);
+
+    for (size_t i = 0; i < analysis.jumpdest_offsets.size(); ++i)
+    {
+        EXPECT_EQ(find_jumpdest(analysis, analysis.jumpdest_offsets[i]),
+            analysis.jumpdest_targets[i]);
+    }
+    EXPECT_EQ(find_jumpdest(analysis, 3), -1);
+    EXPECT_EQ(find_jumpdest(analysis, 4), -1);
+}
+
+TEST(analysis, jumpdests_bitmap_words)
+{
+    // The JUMPDESTs at the boundaries of the words of the bitmap.
+    const auto code = OP_JUMPDEST + 62 * OP_PC + 2 * OP_JUMPDEST + 62 * OP_PC + OP_JUMPDEST +
+                      72 * OP_PC + OP_JUMPDEST;
+    const auto analysis = analyze(REV, code);
+
+    EXPECT_EQ(analysis.jumpdest_bitmap.size(), 4);
+    ASSERT_EQ(analysis.jumpdest_offsets.size(), 5);
+    EXPECT_EQ(analysis.jumpdest_offsets[1], 63);
+    EXPECT_EQ(analysis.jumpdest_offsets[2], 64);
+    EXPECT_EQ(analysis.jumpdest_offsets[3], 127);
+    EXPECT_EQ(analysis.jumpdest_offsets[4], 200);
+    for (size_t i = 0; i < analysis.jumpdest_offsets.size(); ++i)
+    {
+        EXPECT_EQ(find_jumpdest(analysis, analysis.jumpdest_offsets[i]),
+            analysis.jumpdest_targets[i]);
+    }
+    EXPECT_EQ(find_jumpdest(analysis, 62), -1);
+    EXPECT_EQ(find_jumpdest(analysis, 65), -1);
+    EXPECT_EQ(find_jumpdest(analysis, 128), -1);
+    EXPECT_EQ(find_jumpdest(analysis, 201), -1);
+    EXPECT_EQ(find_jumpdest(analysis, 256), -1);
 }
 
 TEST(analysis, example1_eof1)
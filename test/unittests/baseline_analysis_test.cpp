@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <evmone/baseline.hpp>
+#include <evmone/baseline_superinstructions.hpp>
 #include <gtest/gtest.h>
 #include <test/utils/bytecode.hpp>
 
@@ -19,6 +20,117 @@ TEST(baseline_analysis, legacy)
     EXPECT_NE(analysis.raw_code().data(), code.data()) << "copy should be made";
 }
 
+TEST(baseline_analysis, legacy_code_buffer)
+{
+    const auto code = bytecode{OP_JUMPDEST} + push(0x5b) + 70 * OP_JUMPDEST + OP_PUSH32;
+    const auto analysis = evmone::baseline::analyze(code, false);
+    const auto executable_code = analysis.executable_code();
+
+    const auto addr = reinterpret_cast<uintptr_t>(executable_code.data());
+    EXPECT_EQ(addr % evmone::baseline::CodeAnalysis::BUFFER_ALIGNMENT, 0);
+
+    // The code is padded with STOPs.
+    for (size_t i = 0; i < evmone::baseline::CodeAnalysis::CODE_PADDING; ++i)
+        EXPECT_EQ(executable_code.data()[code.size() + i], OP_STOP);
+
+    EXPECT_TRUE(analysis.check_jumpdest(0));
+    EXPECT_FALSE(analysis.check_jumpdest(1));
+    EXPECT_FALSE(analysis.check_jumpdest(2));
+    for (size_t i = 3; i < 73; ++i)
+        EXPECT_TRUE(analysis.check_jumpdest(i)) << i;
+    EXPECT_FALSE(analysis.check_jumpdest(73));
+    EXPECT_FALSE(analysis.check_jumpdest(code.size()));
+    EXPECT_FALSE(analysis.check_jumpdest(std::numeric_limits<uint64_t>::max()));
+}
+
+TEST(baseline_analysis, legacy_superinstructions)
+{
+    using namespace evmone::baseline;
+    const auto code = push(4) + OP_JUMP + "b0" + OP_JUMPDEST + push("b0") + OP_DUP1 + OP_SWAP2 +
+                      OP_ISZERO + push("0004") + OP_JUMPI + OP_PUSH1;
+    const auto analysis = analyze(code, false, {.superinstructions = true});
+
+    EXPECT_TRUE(analysis.has_superinstructions());
+    EXPECT_EQ(analysis.raw_code(), code);
+    EXPECT_TRUE(analysis.check_jumpdest(4));
+
+    // Only the first opcodes of the fused sequences and the colliding undefined opcodes
+    // are replaced.
+    auto expected = code;
+    expected[0] = OP_PUSH1_JUMP;
+    expected[3] = OP_UNDEFINED_REPLACEMENT;
+    expected[7] = OP_DUP1_SWAP2;
+    expected[9] = OP_ISZERO_PUSH2_JUMPI;
+    EXPECT_EQ(analysis.executable_code(), expected);
+    for (size_t i = 0; i < CodeAnalysis::CODE_PADDING; ++i)
+        EXPECT_EQ(analysis.executable_code().data()[code.size() + i], OP_STOP);
+
+    EXPECT_FALSE(analyze(code, false).has_superinstructions());
+    const bytecode container = eof_bytecode(OP_STOP);
+    EXPECT_FALSE(analyze(container, true, {.superinstructions = true}).has_superinstructions());
+}
+
+TEST(baseline_analysis, legacy_block_checks)
+{
+    using namespace evmone::baseline;
+    const auto code = push(1) + OP_DUP1 + OP_ADD + OP_GAS + OP_POP + OP_JUMPDEST + OP_DUP2 +
+                      push(0) + OP_JUMPI + OP_SLOAD + OP_STOP + OP_ADD + OP_JUMPDEST + OP_CALL;
+    const auto analysis = analyze(code, false, {.block_checks = true, .rev = EVMC_BERLIN});
+
+    EXPECT_TRUE(analysis.has_block_checks(EVMC_BERLIN));
+    EXPECT_FALSE(analysis.has_block_checks(EVMC_LONDON));
+    EXPECT_FALSE(analysis.has_superinstructions());
+    EXPECT_EQ(analysis.executable_code(), code);
+
+    // PUSH1 DUP1 ADD GAS.
+    EXPECT_EQ(analysis.block_at(0).gas_cost, 3 + 3 + 3 + 2);
+    EXPECT_EQ(analysis.block_at(0).stack_req, 0);
+    EXPECT_EQ(analysis.block_at(0).stack_max_growth, 2);
+
+    // POP.
+    EXPECT_EQ(analysis.block_at(5).gas_cost, 2);
+    EXPECT_EQ(analysis.block_at(5).stack_req, 1);
+    EXPECT_EQ(analysis.block_at(5).stack_max_growth, 0);
+
+    // JUMPDEST DUP2 PUSH1 JUMPI.
+    EXPECT_EQ(analysis.block_at(6).gas_cost, 1 + 3 + 3 + 10);
+    EXPECT_EQ(analysis.block_at(6).stack_req, 2);
+    EXPECT_EQ(analysis.block_at(6).stack_max_growth, 2);
+
+    // SLOAD STOP. The ADD after STOP is unreachable.
+    EXPECT_EQ(analysis.block_at(11).gas_cost, 100);
+    EXPECT_EQ(analysis.block_at(11).stack_req, 1);
+
+    // JUMPDEST CALL and the empty block at the code end.
+    EXPECT_EQ(analysis.block_at(14).gas_cost, 1 + 100);
+    EXPECT_EQ(analysis.block_at(14).stack_req, 7);
+    EXPECT_EQ(analysis.block_at(14).stack_max_growth, 0);
+    EXPECT_EQ(analysis.block_at(code.size()).gas_cost, 0);
+    EXPECT_EQ(analysis.block_at(code.size()).stack_req, 0);
+
+    // The block checks use the original code.
+    EXPECT_FALSE(analyze(code, false, {.superinstructions = true, .block_checks = true})
+                     .has_superinstructions());
+    const bytecode container = eof_bytecode(OP_STOP);
+    EXPECT_FALSE(analyze(container, true, {.block_checks = true}).has_block_checks(EVMC_FRONTIER));
+}
+
+TEST(baseline_analysis, legacy_jit)
+{
+    using namespace evmone::baseline;
+    const auto code = push(1) + OP_JUMPDEST + OP_DUP1 + OP_ADD + push(1) + OP_JUMP;
+    const auto analysis = analyze(code, false, {.jit = true, .rev = EVMC_CANCUN});
+
+    // The native code requires the block checks.
+    EXPECT_TRUE(analysis.has_block_checks(EVMC_CANCUN));
+    EXPECT_FALSE(analysis.has_superinstructions());
+    EXPECT_EQ(static_cast<bool>(analysis.jit_code()), EVMONE_JIT_SUPPORTED != 0);
+
+    EXPECT_FALSE(analyze(code, false, {.block_checks = true}).jit_code());
+    const bytecode container = eof_bytecode(OP_STOP);
+    EXPECT_FALSE(analyze(container, true, {.jit = true}).jit_code());
+}
+
 TEST(baseline_analysis, eof1)
 {
     const auto code = push(1) + ret_top();
@@ -32,3 +144,26 @@ TEST(baseline_analysis, eof1)
     EXPECT_EQ(analysis.raw_code(), container);
     EXPECT_EQ(analysis.raw_code().data(), container.data()) << "copy should not be made";
 }
+
+TEST(baseline_analysis, eof1_code_sections)
+{
+    const bytecode container = eof_bytecode(callf(1) + OP_STOP, 2)
+                                   .code(push(1) + push(2) + OP_POP + OP_RETF, 0, 1, 2)
+                                   .code(OP_POP + push(1) + push(2) + OP_POP + OP_RETF, 2, 2, 3);
+    const auto analysis = evmone::baseline::analyze(container, true);
+    const auto& header = analysis.eof_header();
+    ASSERT_EQ(header.code_sizes.size(), 3);
+
+    for (size_t i = 0; i < header.code_sizes.size(); ++i)
+    {
+        const auto& section = analysis.eof_code_section(i);
+        const auto type = header.get_type(container, i);
+        EXPECT_EQ(section.code, &container[header.code_offsets[i]]);
+        EXPECT_EQ(section.inputs, type.inputs);
+        EXPECT_EQ(section.outputs, type.outputs);
+        EXPECT_EQ(section.max_stack_increase, type.max_stack_height - type.inputs);
+    }
+    EXPECT_EQ(analysis.eof_code_section(0).code, analysis.executable_code().data());
+    EXPECT_EQ(analysis.eof_code_section(1).max_stack_increase, 2);
+    EXPECT_EQ(analysis.eof_code_section(2).max_stack_increase, 1);
+}
@@ -0,0 +1,123 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test/utils/bytecode.hpp"
+#include <evmc/evmc.hpp>
+#include <evmc/mocked_host.hpp>
+#include <evmone/baseline_aot_runtime.hpp>
+#include <evmone/evmone.h>
+#include <evmone/vm.hpp>
+#include <ethash/keccak.hpp>
+#include <gtest/gtest.h>
+#include <cstring>
+
+using namespace evmone;
+using namespace evmone::baseline;
+using namespace evmone::test;
+
+namespace
+{
+/// The code of the compiled contract below.
+const auto code = push(4) + OP_JUMP + OP_INVALID + OP_JUMPDEST + push(0) + OP_SLOAD + ret_top();
+
+int num_compiled_calls = 0;
+
+/// The contract code compiled the way the evmone-aotc does.
+int64_t compiled_contract(ExecutionState& state, int64_t gas, const AotSupport& support) noexcept
+{
+    ++num_compiled_calls;
+    AotFrame f{state, gas, support};
+    if (!f.step<OP_PUSH1>(0))
+        return f.gas;
+    if (!f.step<OP_JUMP>(2))
+        return f.gas;
+    goto dispatch;
+L_4:
+    if (!f.step<OP_JUMPDEST>(4))
+        return f.gas;
+    if (!f.step<OP_PUSH1>(5))
+        return f.gas;
+    if (!f.step<OP_SLOAD>(7))
+        return f.gas;
+    if (!f.step<OP_PUSH1>(8))
+        return f.gas;
+    if (!f.step<OP_MSTORE>(10))
+        return f.gas;
+    if (!f.step<OP_PUSH1>(11))
+        return f.gas;
+    if (!f.step<OP_PUSH1>(13))
+        return f.gas;
+    if (!f.step<OP_RETURN>(15))
+        return f.gas;
+dispatch:
+    switch (f.next_position())
+    {
+    case 4:
+        goto L_4;
+    default:
+        f.undefined();
+        return f.gas;
+    }
+}
+
+AotContract make_aot_contract(bytes_view c, AotFn fn)
+{
+    const auto hash = ethash::keccak256(c.data(), c.size());
+    AotContract contract{.code_size = c.size(), .fn = fn};
+    std::memcpy(contract.code_hash.bytes, hash.bytes, sizeof(hash));
+    return contract;
+}
+}  // namespace
+
+TEST(baseline_aot, execute_compiled_contract)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_TRUE(evmone_vm.get_aot_registry().empty());
+
+    evmc::MockedHost host;
+    host.accounts[{}].storage[{}].current = evmc::bytes32{0xaa};
+    evmc_message msg{};
+    msg.gas = 100000;
+
+    const auto expected = vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+    ASSERT_EQ(expected.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(num_compiled_calls, 0);
+
+    evmone_vm.get_aot_registry().add(make_aot_contract(code, compiled_contract));
+    EXPECT_FALSE(evmone_vm.get_aot_registry().empty());
+    EXPECT_EQ(evmone_vm.get_aot_registry().find(code), compiled_contract);
+    EXPECT_EQ(evmone_vm.get_aot_registry().find(code + OP_STOP), nullptr);
+
+    const auto result = vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+    EXPECT_EQ(num_compiled_calls, 1);
+    EXPECT_EQ(result.status_code, expected.status_code);
+    EXPECT_EQ(result.gas_left, expected.gas_left);
+    EXPECT_EQ(bytes_view(result.output_data, result.output_size),
+        bytes_view(expected.output_data, expected.output_size));
+
+    // Out of gas in the compiled code.
+    msg.gas -= expected.gas_left + 1;
+    const auto oog_result = vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+    EXPECT_EQ(num_compiled_calls, 2);
+    EXPECT_EQ(oog_result.status_code, EVMC_OUT_OF_GAS);
+    EXPECT_EQ(oog_result.gas_left, 0);
+}
+
+TEST(baseline_aot, initcode_not_compiled)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    evmone_vm.get_aot_registry().add(make_aot_contract(code, compiled_contract));
+
+    evmc::MockedHost host;
+    evmc_message msg{};
+    msg.kind = EVMC_CREATE;
+    msg.gas = 100000;
+
+    const auto num_calls = num_compiled_calls;
+    const auto result = vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(num_compiled_calls, num_calls);
+}
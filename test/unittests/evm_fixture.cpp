@@ -4,6 +4,7 @@
 
 #include "evm_fixture.hpp"
 #include <evmone/evmone.h>
+#include <evmone/vm.hpp>
 
 namespace evmone::test
 {
@@ -12,6 +13,24 @@ namespace
 evmc::VM advanced_vm{evmc_create_evmone(), {{"advanced", ""}}};
 evmc::VM baseline_vm{evmc_create_evmone()};
 evmc::VM bnocgoto_vm{evmc_create_evmone(), {{"cgoto", "no"}}};
+evmc::VM bcache_vm{evmc_create_evmone(), {{"analysis_cache", "1"}}};
+evmc::VM bfused_vm{evmc_create_evmone(), {{"superinstructions", "yes"}}};
+evmc::VM bfusednocgoto_vm{evmc_create_evmone(), {{"superinstructions", "yes"}, {"cgoto", "no"}}};
+evmc::VM bblocks_vm{evmc_create_evmone(), {{"block_checks", "yes"}}};
+evmc::VM bblocksnocgoto_vm{evmc_create_evmone(), {{"block_checks", "yes"}, {"cgoto", "no"}}};
+#if EVMONE_TAILCALL_SUPPORTED
+// Without the tail call support the "tailcall" dispatch option is rejected
+// and these would duplicate the instances of the default dispatch.
+evmc::VM btailcall_vm{evmc_create_evmone(), {{"dispatch", "tailcall"}}};
+evmc::VM bfusedtailcall_vm{
+    evmc_create_evmone(), {{"superinstructions", "yes"}, {"dispatch", "tailcall"}}};
+evmc::VM bblockstailcall_vm{
+    evmc_create_evmone(), {{"block_checks", "yes"}, {"dispatch", "tailcall"}}};
+#endif
+evmc::VM bjit_vm{evmc_create_evmone(), {{"jit", "yes"}, {"analysis_cache", "1"}}};
+evmc::VM bstackarena_vm{evmc_create_evmone(), {{"stack_arena", "yes"}}};
+evmc::VM bmappedmemory_vm{evmc_create_evmone(), {{"mapped_memory", "yes"}}};
+evmc::VM bstoragecache_vm{evmc_create_evmone(), {{"storage_cache", "yes"}}};
 
 const char* print_vm_name(const testing::TestParamInfo<evmc::VM*>& info) noexcept
 {
@@ -21,15 +40,70 @@ const char* print_vm_name(const testing::TestParamInfo<evmc::VM*>& info) noexcep
         return "baseline";
     if (info.param == &bnocgoto_vm)
         return "bnocgoto";
+    if (info.param == &bcache_vm)
+        return "bcache";
+    if (info.param == &bfused_vm)
+        return "bfused";
+    if (info.param == &bfusednocgoto_vm)
+        return "bfusednocgoto";
+    if (info.param == &bblocks_vm)
+        return "bblocks";
+    if (info.param == &bblocksnocgoto_vm)
+        return "bblocksnocgoto";
+#if EVMONE_TAILCALL_SUPPORTED
+    if (info.param == &btailcall_vm)
+        return "btailcall";
+    if (info.param == &bfusedtailcall_vm)
+        return "bfusedtailcall";
+    if (info.param == &bblockstailcall_vm)
+        return "bblockstailcall";
+#endif
+    if (info.param == &bjit_vm)
+        return "bjit";
+    if (info.param == &bstackarena_vm)
+        return "bstackarena";
+    if (info.param == &bmappedmemory_vm)
+        return "bmappedmemory";
+    if (info.param == &bstoragecache_vm)
+        return "bstoragecache";
     return "unknown";
 }
+
+evmc::VM* const vms[] = {
+    &advanced_vm,
+    &baseline_vm,
+    &bnocgoto_vm,
+    &bcache_vm,
+    &bfused_vm,
+    &bfusednocgoto_vm,
+    &bblocks_vm,
+    &bblocksnocgoto_vm,
+#if EVMONE_TAILCALL_SUPPORTED
+    &btailcall_vm,
+    &bfusedtailcall_vm,
+    &bblockstailcall_vm,
+#endif
+    &bjit_vm,
+    &bstackarena_vm,
+    &bmappedmemory_vm,
+    &bstoragecache_vm,
+};
 }  // namespace
 
-INSTANTIATE_TEST_SUITE_P(
-    evmone, evm, testing::Values(&advanced_vm, &baseline_vm, &bnocgoto_vm), print_vm_name);
+INSTANTIATE_TEST_SUITE_P(evmone, evm, testing::ValuesIn(vms), print_vm_name);
 
 bool evm::is_advanced() noexcept
 {
     return GetParam() == &advanced_vm;
 }
+
+bool evm::checks_blocks() noexcept
+{
+#if EVMONE_TAILCALL_SUPPORTED
+    if (GetParam() == &bblockstailcall_vm)
+        return true;
+#endif
+    return GetParam() == &advanced_vm || GetParam() == &bblocks_vm ||
+           GetParam() == &bblocksnocgoto_vm || GetParam() == &bjit_vm;
+}
 }  // namespace evmone::test
@@ -36,6 +36,10 @@ protected:
     /// Reports if execution is done by evmone/Advanced.
     static bool is_advanced() noexcept;
 
+    /// Reports if the instruction requirements are checked once per basic block:
+    /// by evmone/Advanced or evmone/Baseline with the block checks.
+    static bool checks_blocks() noexcept;
+
     /// The VM handle.
     evmc::VM& vm;
 
@@ -116,6 +116,49 @@ TEST_P(evm, evmone_block_gas_cost_overflow_balance)
     }
 }
 
+TEST_P(evm, evmone_block_gas_in_the_middle)
+{
+    // The GAS instruction in the middle of the basic block must not see the base cost
+    // of the following instructions already charged.
+    const auto code = push(1) + OP_POP + OP_GAS + push(2) + OP_ADD + ret_top();
+    execute(100, code);
+    EXPECT_GAS_USED(EVMC_SUCCESS, 3 + 2 + 2 + 3 + 3 + 9 + 6);
+    EXPECT_OUTPUT_INT(100 - 3 - 2 - 2 + 2);
+
+    // The block after the GAS instruction runs out of gas.
+    execute(3 + 2 + 2 + 3 + 2, code);
+    EXPECT_STATUS(EVMC_OUT_OF_GAS);
+}
+
+TEST_P(evm, evmone_block_after_jumpi)
+{
+    // The block after not taken JUMPI is checked separately.
+    const auto code = jumpi(push(9), push(0)) + push(1) + OP_ADD;
+    execute(code);
+    EXPECT_STATUS(EVMC_STACK_UNDERFLOW);
+    execute(3 + 3 + 10 + 2, code + OP_POP);
+    EXPECT_STATUS(EVMC_OUT_OF_GAS);
+
+    // The block after the JUMPI starting with JUMPDEST is charged once.
+    execute(jumpi(push(9), push(0)) + OP_JUMPDEST + push(1) + ret_top());
+    EXPECT_GAS_USED(EVMC_SUCCESS, 3 + 3 + 10 + 1 + 3 + 9 + 6);
+    EXPECT_OUTPUT_INT(1);
+}
+
+TEST_P(evm, evmone_block_undefined_instruction)
+{
+    // PUSH0 is undefined before Shanghai. The basic block requirements depend on the revision.
+    const auto code = push(1) + OP_PUSH0 + ret_top();
+    rev = EVMC_PARIS;
+    execute(code);
+    EXPECT_STATUS(EVMC_UNDEFINED_INSTRUCTION);
+
+    rev = EVMC_SHANGHAI;
+    execute(code);
+    EXPECT_GAS_USED(EVMC_SUCCESS, 3 + 2 + 9 + 6);
+    EXPECT_OUTPUT_INT(0);
+}
+
 TEST_P(evm, loop_full_of_jumpdests)
 {
     // The code is a simple loop with a counter taken from the input or a constant (325) if the
@@ -302,4 +302,8 @@ TEST_P(evm, sstore_below_stipend)
 
     execute(2307, code);
     EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+
+    // The base cost of the instructions after SSTORE must not be charged before it.
+    execute(2307 + 5, code + push(1) + OP_POP);
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
 }
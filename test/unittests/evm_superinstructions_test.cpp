@@ -0,0 +1,161 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+/// This file contains EVM unit tests of the instruction sequences replaced with
+/// the superinstructions in the Baseline interpreter. The results must be the same for all VMs.
+
+#include "evm_fixture.hpp"
+
+using namespace evmone::test;
+
+TEST_P(evm, fused_push_jump)
+{
+    const auto code = push(4) + OP_JUMP + OP_INVALID + OP_JUMPDEST +          // PUSH1 JUMP
+                      push("000a") + OP_JUMP + OP_INVALID + OP_JUMPDEST +    // PUSH2 JUMP
+                      push("000011") + OP_JUMP + OP_INVALID + OP_JUMPDEST +  // PUSH3 JUMP
+                      push(0x2a) + ret_top();
+    execute(code);
+    EXPECT_GAS_USED(EVMC_SUCCESS, 3 * (3 + 8 + 1) + 3 + 9 + 6);
+    EXPECT_OUTPUT_INT(0x2a);
+
+    execute(push(3) + OP_JUMP + OP_STOP + OP_STOP);
+    EXPECT_STATUS(EVMC_BAD_JUMP_DESTINATION);
+
+    execute(push("0100") + OP_JUMP);
+    EXPECT_STATUS(EVMC_BAD_JUMP_DESTINATION);
+
+    execute(1024 * push(1) + push(0) + OP_JUMP);
+    EXPECT_STATUS(EVMC_STACK_OVERFLOW);
+
+    execute(10, push(4) + OP_JUMP + OP_INVALID + OP_JUMPDEST);
+    EXPECT_STATUS(EVMC_OUT_OF_GAS);
+}
+
+TEST_P(evm, fused_push_jumpi)
+{
+    const auto code = jumpi(push(7), calldataload(0)) + OP_STOP + OP_JUMPDEST + push(1) + ret_top();
+    execute(code, "01"_hex);
+    EXPECT_GAS_USED(EVMC_SUCCESS, 3 + 3 + 3 + 10 + 1 + 3 + 9 + 6);
+    EXPECT_OUTPUT_INT(1);
+
+    execute(code);
+    EXPECT_GAS_USED(EVMC_SUCCESS, 3 + 3 + 3 + 10);
+    EXPECT_EQ(result.output_size, 0);
+
+    execute(jumpi(push("000004"), push(1)));
+    EXPECT_STATUS(EVMC_BAD_JUMP_DESTINATION);
+
+    execute(1024 * push(1) + push(0) + OP_JUMPI);
+    EXPECT_STATUS(EVMC_STACK_OVERFLOW);
+
+    execute(3 + 12, jumpi(push(7), push(0)));
+    EXPECT_STATUS(EVMC_OUT_OF_GAS);
+}
+
+TEST_P(evm, fused_push1_add)
+{
+    execute(push(2) + push(3) + OP_ADD + ret_top());
+    EXPECT_GAS_USED(EVMC_SUCCESS, 3 + 3 + 3 + 9 + 6);
+    EXPECT_OUTPUT_INT(5);
+
+    execute(push(~intx::uint256{}) + push(1) + OP_ADD + ret_top());
+    EXPECT_OUTPUT_INT(0);
+
+    execute(1024 * push(1) + push(1) + OP_ADD);
+    EXPECT_STATUS(EVMC_STACK_OVERFLOW);
+
+    execute(3 + 5, push(1) + push(1) + OP_ADD);
+    EXPECT_STATUS(EVMC_OUT_OF_GAS);
+}
+
+TEST_P(evm, fused_iszero_push_jumpi)
+{
+    const auto code = push(0) + OP_ISZERO + push(7) + OP_JUMPI + OP_INVALID + OP_JUMPDEST +
+                      push(1) + ret_top();
+    execute(code);
+    EXPECT_GAS_USED(EVMC_SUCCESS, 3 + 3 + 3 + 10 + 1 + 3 + 9 + 6);
+    EXPECT_OUTPUT_INT(1);
+
+    execute(push(5) + OP_ISZERO + push("0100") + OP_JUMPI + push(2) + ret_top());
+    EXPECT_GAS_USED(EVMC_SUCCESS, 3 + 3 + 3 + 10 + 3 + 9 + 6);
+    EXPECT_OUTPUT_INT(2);
+
+    execute(push(0) + OP_ISZERO + push("000100") + OP_JUMPI);
+    EXPECT_STATUS(EVMC_BAD_JUMP_DESTINATION);
+
+    execute(OP_ISZERO + push(5) + OP_JUMPI);
+    EXPECT_STATUS(EVMC_STACK_UNDERFLOW);
+
+    execute(1024 * push(1) + OP_ISZERO + push(0) + OP_JUMPI);
+    EXPECT_STATUS(EVMC_STACK_OVERFLOW);
+
+    execute(3 + 15, push(1) + OP_ISZERO + push(0) + OP_JUMPI);
+    EXPECT_STATUS(EVMC_OUT_OF_GAS);
+}
+
+TEST_P(evm, fused_dup_swap)
+{
+    execute(push(1) + push(2) + push(3) + OP_DUP2 + OP_SWAP3 + ret_top());
+    EXPECT_GAS_USED(EVMC_SUCCESS, 3 * 3 + 3 + 3 + 9 + 6);
+    EXPECT_OUTPUT_INT(1);
+
+    execute(push(1) + push(2) + OP_DUP1 + OP_SWAP1 + OP_DUP4 + OP_SWAP4);
+    EXPECT_STATUS(EVMC_STACK_UNDERFLOW);
+
+    execute(push(1) + OP_DUP2 + OP_SWAP1);
+    EXPECT_STATUS(EVMC_STACK_UNDERFLOW);
+
+    execute(1024 * push(1) + OP_DUP1 + OP_SWAP1);
+    EXPECT_STATUS(EVMC_STACK_OVERFLOW);
+
+    execute(3 + 5, push(1) + OP_DUP1 + OP_SWAP1);
+    EXPECT_STATUS(EVMC_OUT_OF_GAS);
+}
+
+TEST_P(evm, fused_requirements_order)
+{
+    // The status code of the first failing instruction in the sequence is reported.
+    // With the block checks the gas of the whole block is checked before the stack requirements.
+    if (checks_blocks())
+        return;
+
+    // The PUSH runs out of gas before the JUMPI underflows.
+    execute(2, push(1) + OP_JUMPI);
+    EXPECT_STATUS(EVMC_OUT_OF_GAS);
+    execute(3, push(1) + OP_JUMPI);
+    EXPECT_STATUS(EVMC_STACK_UNDERFLOW);
+
+    // The PUSH runs out of gas before the ADD underflows.
+    execute(2, push(1) + OP_ADD);
+    EXPECT_STATUS(EVMC_OUT_OF_GAS);
+    execute(3, push(1) + OP_ADD);
+    EXPECT_STATUS(EVMC_STACK_UNDERFLOW);
+
+    // The ISZERO runs out of gas before the PUSH overflows.
+    const auto overflow_code = 1024 * push(1) + OP_ISZERO + push(0) + OP_JUMPI;
+    execute(1024 * 3 + 2, overflow_code);
+    EXPECT_STATUS(EVMC_OUT_OF_GAS);
+    execute(1024 * 3 + 3, overflow_code);
+    EXPECT_STATUS(EVMC_STACK_OVERFLOW);
+
+    // The DUP runs out of gas before the SWAP underflows.
+    execute(3 + 2, push(1) + OP_DUP1 + OP_SWAP3);
+    EXPECT_STATUS(EVMC_OUT_OF_GAS);
+    execute(3 + 3, push(1) + OP_DUP1 + OP_SWAP3);
+    EXPECT_STATUS(EVMC_STACK_UNDERFLOW);
+}
+
+TEST_P(evm, fused_opcodes_undefined)
+{
+    // The opcodes reserved for the superinstructions are undefined in the original code.
+    for (const auto op : {0xb0, 0xb6, 0xb9, 0xc0, 0xcf})
+    {
+        execute(push(1) + bytecode{bytes{static_cast<uint8_t>(op)}} + OP_JUMP);
+        EXPECT_STATUS(EVMC_UNDEFINED_INSTRUCTION);
+    }
+
+    // The PUSH data is not modified.
+    execute(push("b0") + ret_top());
+    EXPECT_OUTPUT_INT(0xb0);
+}
@@ -280,6 +280,42 @@ TEST_P(evm, addmod_mulmod)
         "34e04890131a297202753cae4c72efd508962c9129aed8b08c8e87ab425b7258"_hex);
 }
 
+TEST_P(evm, mulmod_repeated_modulus)
+{
+    // The moduli repeated in the row get cached. There are more odd moduli than cache entries.
+    constexpr uint256 moduli[]{
+        0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47_u256,
+        0xfffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f_u256,
+        3,
+        ~uint256{0},
+        uint256{1} << 255,
+    };
+    constexpr auto big = 0xcdeb8272fc01d4d50a6ec165d2ea477af19b9b2c198459f59079583b97e88a66_u256;
+
+    bytecode code;
+    std::vector<uint256> expected;
+    for (int round = 0; round < 2; ++round)
+    {
+        for (const auto& m : moduli)
+        {
+            const std::pair<uint256, uint256> args[]{
+                {m - 1, m - 1}, {m + 1, big}, {~m, ~m}, {big, 0}};
+            for (const auto& [x, y] : args)
+            {
+                code += push(m) + push(y) + push(x) + OP_MULMOD + mstore(expected.size() * 32);
+                expected.push_back(mulmod(x, y, m));
+            }
+        }
+    }
+    code += ret(0, expected.size() * 32);
+
+    execute(code);
+    EXPECT_STATUS(EVMC_SUCCESS);
+    ASSERT_EQ(result.output_size, expected.size() * 32);
+    for (size_t i = 0; i < expected.size(); ++i)
+        EXPECT_EQ(be::unsafe::load<uint256>(&result.output_data[i * 32]), expected[i]);
+}
+
 TEST_P(evm, divmod)
 {
     // Div and mod the -1 by the input and return.
@@ -293,6 +329,54 @@ TEST_P(evm, divmod)
         "08ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"_hex);
 }
 
+TEST_P(evm, arithmetic_word_values)
+{
+    // The values fitting in a word use the fast paths. The results must match the full
+    // 256-bit arithmetic, also on the boundaries of the word.
+    constexpr uint64_t max = ~uint64_t{0};
+    const std::pair<uint256, uint256> args[]{{0, 0}, {7, 0}, {0, 7}, {max, max}, {max, 3},
+        {uint64_t{1} << 63, 2}, {10, 18}, {10, 19}, {10, 20}, {3, 161}, {max, 2}, {max, max - 1},
+        {uint256{1} << 64, 3}, {5, uint256{1} << 64}, {2, 255}, {2, 256}, {~uint256{0}, 2}};
+
+    bytecode code;
+    std::vector<uint256> expected;
+    for (const auto& [x, y] : args)
+    {
+        for (const auto op : {OP_MUL, OP_DIV, OP_SDIV, OP_MOD, OP_SMOD, OP_EXP})
+        {
+            code += push(y) + push(x) + op + mstore(expected.size() * 32);
+            switch (op)
+            {
+            case OP_MUL:
+                expected.push_back(x * y);
+                break;
+            case OP_DIV:
+                expected.push_back(y != 0 ? x / y : 0);
+                break;
+            case OP_SDIV:
+                expected.push_back(y != 0 ? sdivrem(x, y).quot : 0);
+                break;
+            case OP_MOD:
+                expected.push_back(y != 0 ? x % y : 0);
+                break;
+            case OP_SMOD:
+                expected.push_back(y != 0 ? sdivrem(x, y).rem : 0);
+                break;
+            default:
+                expected.push_back(intx::exp(x, y));
+                break;
+            }
+        }
+    }
+    code += ret(0, expected.size() * 32);
+
+    execute(code);
+    EXPECT_STATUS(EVMC_SUCCESS);
+    ASSERT_EQ(result.output_size, expected.size() * 32);
+    for (size_t i = 0; i < expected.size(); ++i)
+        EXPECT_EQ(be::unsafe::load<uint256>(&result.output_data[i * 32]), expected[i]) << i;
+}
+
 TEST_P(evm, div_by_zero)
 {
     execute(34, dup1(push(0)) + push(0xff) + OP_DIV + OP_SDIV + ret_top());
@@ -638,6 +722,37 @@ TEST_P(evm, undefined_instructions)
     }
 }
 
+TEST_P(evm, base_gas_costs)
+{
+    // The instructions without inputs having only the base gas cost.
+    // The latest revisions are executed by the revision-specialized dispatch of Baseline.
+    constexpr Opcode ops[]{OP_ADDRESS, OP_ORIGIN, OP_CALLER, OP_CALLVALUE, OP_CALLDATASIZE,
+        OP_CODESIZE, OP_GASPRICE, OP_RETURNDATASIZE, OP_COINBASE, OP_TIMESTAMP, OP_NUMBER,
+        OP_PREVRANDAO, OP_GASLIMIT, OP_CHAINID, OP_SELFBALANCE, OP_BASEFEE, OP_BLOBBASEFEE, OP_PC,
+        OP_MSIZE, OP_GAS, OP_PUSH0};
+
+    for (auto i = 0; i <= EVMC_MAX_REVISION; ++i)
+    {
+        rev = evmc_revision(i);
+        for (const auto op : ops)
+        {
+            execute(bytecode{} + op);
+            const auto cost = evmone::instr::gas_costs[rev][op];
+            if (cost == evmone::instr::undefined)
+            {
+                EXPECT_EQ(result.status_code, EVMC_UNDEFINED_INSTRUCTION)
+                    << " for opcode " << hex(op) << " on revision " << rev;
+            }
+            else
+            {
+                EXPECT_EQ(result.status_code, EVMC_SUCCESS)
+                    << " for opcode " << hex(op) << " on revision " << rev;
+                EXPECT_EQ(gas_used, cost) << " for opcode " << hex(op) << " on revision " << rev;
+            }
+        }
+    }
+}
+
 TEST_P(evm, undefined_instruction_analysis_overflow)
 {
     rev = EVMC_PETERSBURG;
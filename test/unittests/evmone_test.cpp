@@ -2,10 +2,16 @@
 // Copyright 2019-2020 The evmone Authors.
 // SPDX-License-Identifier: Apache-2.0
 
+#include "test/utils/bytecode.hpp"
 #include <evmc/evmc.hpp>
+#include <evmc/mocked_host.hpp>
 #include <evmone/evmone.h>
 #include <evmone/vm.hpp>
 #include <gtest/gtest.h>
+#include <array>
+#include <thread>
+#include <utility>
+#include <vector>
 
 TEST(evmone, info)
 {
@@ -53,3 +59,416 @@ TEST(evmone, set_option_cgoto)
     EXPECT_EQ(vm.set_option("cgoto", "no"), EVMC_SET_OPTION_INVALID_NAME);
 #endif
 }
+
+TEST(evmone, set_option_cgoto_resets_dispatch)
+{
+#if !EVMONE_CGOTO_SUPPORTED || !EVMONE_TAILCALL_SUPPORTED
+    GTEST_SKIP() << "cgoto or tailcall dispatch not supported";
+#else
+    evmc::VM vm{evmc_create_evmone()};
+    const auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_EQ(vm.set_option("dispatch", "tailcall"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_EQ(vm.set_option("cgoto", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_FALSE(evmone_vm.cgoto);
+    EXPECT_FALSE(evmone_vm.tailcall);
+#endif
+}
+
+TEST(evmone, set_option_dispatch)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    const auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_FALSE(evmone_vm.tailcall);
+
+    EXPECT_EQ(vm.set_option("dispatch", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_EQ(vm.set_option("dispatch", "goto"), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_EQ(vm.set_option("dispatch", "switch"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_FALSE(evmone_vm.cgoto);
+    EXPECT_FALSE(evmone_vm.tailcall);
+
+#if EVMONE_CGOTO_SUPPORTED
+    EXPECT_EQ(vm.set_option("dispatch", "cgoto"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_TRUE(evmone_vm.cgoto);
+#else
+    EXPECT_EQ(vm.set_option("dispatch", "cgoto"), EVMC_SET_OPTION_INVALID_VALUE);
+#endif
+
+#if EVMONE_TAILCALL_SUPPORTED
+    EXPECT_EQ(vm.set_option("dispatch", "tailcall"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_TRUE(evmone_vm.tailcall);
+    EXPECT_FALSE(evmone_vm.cgoto);
+#else
+    EXPECT_EQ(vm.set_option("dispatch", "tailcall"), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_FALSE(evmone_vm.tailcall);
+#endif
+}
+
+TEST(evmone, set_option_superinstructions)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    const auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_FALSE(evmone_vm.superinstructions);
+
+    EXPECT_EQ(vm.set_option("superinstructions", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_EQ(vm.set_option("superinstructions", "1"), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_FALSE(evmone_vm.superinstructions);
+    EXPECT_EQ(vm.set_option("superinstructions", "yes"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_TRUE(evmone_vm.superinstructions);
+    EXPECT_EQ(vm.set_option("superinstructions", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_FALSE(evmone_vm.superinstructions);
+}
+
+TEST(evmone, set_option_block_checks)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    const auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_FALSE(evmone_vm.block_checks);
+
+    EXPECT_EQ(vm.set_option("block_checks", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_FALSE(evmone_vm.block_checks);
+    EXPECT_EQ(vm.set_option("block_checks", "yes"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_TRUE(evmone_vm.block_checks);
+    EXPECT_EQ(vm.set_option("block_checks", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_FALSE(evmone_vm.block_checks);
+}
+
+TEST(evmone, set_option_jit)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    const auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_FALSE(evmone_vm.jit);
+
+    EXPECT_EQ(vm.set_option("jit", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_FALSE(evmone_vm.jit);
+#if EVMONE_JIT_SUPPORTED
+    EXPECT_EQ(vm.set_option("jit", "yes"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_TRUE(evmone_vm.jit);
+#else
+    EXPECT_EQ(vm.set_option("jit", "yes"), EVMC_SET_OPTION_INVALID_VALUE);
+#endif
+    EXPECT_EQ(vm.set_option("jit", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_FALSE(evmone_vm.jit);
+}
+
+TEST(evmone, set_option_aot)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_TRUE(evmone_vm.get_aot_registry().empty());
+
+    EXPECT_EQ(vm.set_option("aot", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_EQ(vm.set_option("aot", "/nonexistent/contracts.so"), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_TRUE(evmone_vm.get_aot_registry().empty());
+}
+
+TEST(evmone, set_option_analysis_cache)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_FALSE(evmone_vm.get_analysis_cache().enabled());
+
+    EXPECT_EQ(vm.set_option("analysis_cache", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_EQ(vm.set_option("analysis_cache", "x"), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_EQ(vm.set_option("analysis_cache", "-1"), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_EQ(vm.set_option("analysis_cache", "1 "), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_EQ(vm.set_option("analysis_cache", "99999999999999999999"),
+        EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_FALSE(evmone_vm.get_analysis_cache().enabled());
+
+    EXPECT_EQ(vm.set_option("analysis_cache", "64"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_EQ(evmone_vm.get_analysis_cache().max_size(), 64 * 1024 * 1024);
+
+    EXPECT_EQ(vm.set_option("analysis_cache", "0"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_FALSE(evmone_vm.get_analysis_cache().enabled());
+}
+
+TEST(evmone, set_option_analysis_cache_file)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_EQ(evmone_vm.get_analysis_cache().file(), nullptr);
+
+    EXPECT_EQ(vm.set_option("analysis_cache_file", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_EQ(vm.set_option("analysis_cache_file", "/"), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_EQ(evmone_vm.get_analysis_cache().file(), nullptr);
+}
+
+TEST(evmone, set_option_concurrent)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    const auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_FALSE(evmone_vm.concurrent);
+
+    EXPECT_EQ(vm.set_option("concurrent", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_FALSE(evmone_vm.concurrent);
+    EXPECT_EQ(vm.set_option("concurrent", "yes"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_TRUE(evmone_vm.concurrent);
+    EXPECT_EQ(vm.set_option("concurrent", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_FALSE(evmone_vm.concurrent);
+}
+
+TEST(evmone, set_option_stack_arena)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    const auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_FALSE(evmone_vm.stack_arena);
+
+    EXPECT_EQ(vm.set_option("stack_arena", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_FALSE(evmone_vm.stack_arena);
+#if EVMONE_STACK_ARENA_SUPPORTED
+    EXPECT_EQ(vm.set_option("stack_arena", "yes"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_TRUE(evmone_vm.stack_arena);
+#else
+    EXPECT_EQ(vm.set_option("stack_arena", "yes"), EVMC_SET_OPTION_INVALID_VALUE);
+#endif
+    EXPECT_EQ(vm.set_option("stack_arena", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_FALSE(evmone_vm.stack_arena);
+}
+
+TEST(evmone, stack_arena_reused_state)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    auto& state = evmone_vm.get_execution_state(1);
+    EXPECT_FALSE(state.stack_space.external());
+
+#if EVMONE_STACK_ARENA_SUPPORTED
+    // The option set after the state has been created applies on the reuse.
+    ASSERT_EQ(vm.set_option("stack_arena", "yes"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_EQ(&evmone_vm.get_execution_state(1), &state);
+    EXPECT_TRUE(state.stack_space.external());
+
+    // The stacks of the consecutive depths are adjacent.
+    auto& state0 = evmone_vm.get_execution_state(0);
+    EXPECT_TRUE(state0.stack_space.external());
+    EXPECT_EQ(state.stack_space.bottom() - state0.stack_space.bottom(), evmone::StackSpace::limit);
+#endif
+
+    ASSERT_EQ(vm.set_option("stack_arena", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_EQ(&evmone_vm.get_execution_state(1), &state);
+    EXPECT_FALSE(state.stack_space.external());
+}
+
+TEST(evmone, set_option_mapped_memory)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    const auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_FALSE(evmone_vm.mapped_memory);
+
+    EXPECT_EQ(vm.set_option("mapped_memory", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_FALSE(evmone_vm.mapped_memory);
+#if EVMONE_MAPPED_MEMORY_SUPPORTED
+    EXPECT_EQ(vm.set_option("mapped_memory", "yes"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_TRUE(evmone_vm.mapped_memory);
+#else
+    EXPECT_EQ(vm.set_option("mapped_memory", "yes"), EVMC_SET_OPTION_INVALID_VALUE);
+#endif
+    EXPECT_EQ(vm.set_option("mapped_memory", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_FALSE(evmone_vm.mapped_memory);
+}
+
+TEST(evmone, mapped_memory_reused_state)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    auto& state = evmone_vm.get_execution_state(0);
+    EXPECT_FALSE(state.memory.is_mapped());
+
+#if EVMONE_MAPPED_MEMORY_SUPPORTED
+    // The option set after the state has been created applies on the reuse.
+    ASSERT_EQ(vm.set_option("mapped_memory", "yes"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_EQ(&evmone_vm.get_execution_state(0), &state);
+    EXPECT_TRUE(state.memory.is_mapped());
+
+    // The memory grown above the reservation is mapped again on the reuse.
+    state.memory.grow(size_t{evmone::Memory::mapped_capacity} + 32);
+    EXPECT_FALSE(state.memory.is_mapped());
+    EXPECT_EQ(&evmone_vm.get_execution_state(0), &state);
+    EXPECT_TRUE(state.memory.is_mapped());
+#endif
+
+    ASSERT_EQ(vm.set_option("mapped_memory", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_EQ(&evmone_vm.get_execution_state(0), &state);
+    EXPECT_FALSE(state.memory.is_mapped());
+}
+
+TEST(evmone, set_option_storage_cache)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    const auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_FALSE(evmone_vm.storage_cache);
+
+    EXPECT_EQ(vm.set_option("storage_cache", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_FALSE(evmone_vm.storage_cache);
+    EXPECT_EQ(vm.set_option("storage_cache", "yes"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_TRUE(evmone_vm.storage_cache);
+    EXPECT_EQ(vm.set_option("storage_cache", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_FALSE(evmone_vm.storage_cache);
+}
+
+TEST(evmone, storage_cache_host_calls)
+{
+    using namespace evmone::test;
+
+    /// The host counting the storage queries.
+    class CountingHost : public evmc::MockedHost
+    {
+    public:
+        mutable size_t num_storage_calls = 0;
+
+        evmc::bytes32 get_storage(
+            const evmc::address& addr, const evmc::bytes32& key) const noexcept override
+        {
+            ++num_storage_calls;
+            return MockedHost::get_storage(addr, key);
+        }
+
+        evmc_storage_status set_storage(const evmc::address& addr, const evmc::bytes32& key,
+            const evmc::bytes32& value) noexcept override
+        {
+            ++num_storage_calls;
+            return MockedHost::set_storage(addr, key, value);
+        }
+
+        evmc_access_status access_storage(
+            const evmc::address& addr, const evmc::bytes32& key) noexcept override
+        {
+            ++num_storage_calls;
+            return MockedHost::access_storage(addr, key);
+        }
+    };
+
+    // Increments the slot 10 times and returns it. Then the slot is loaded after a call.
+    const auto code = 10 * sstore(0, add(sload(0), 1)) + call(0).gas(0) + OP_POP +
+                      mstore(0, sload(0)) + ret(0, 32);
+
+    const auto run = [&code](evmc::VM& vm) {
+        CountingHost host;
+        evmc_message msg{};
+        msg.gas = 1000000;
+        const auto r = vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+        EXPECT_EQ(r.status_code, EVMC_SUCCESS);
+        EXPECT_EQ(evmc::bytes_view(r.output_data, r.output_size), evmc::bytes32{10});
+        return std::pair{host.num_storage_calls, r.gas_left};
+    };
+
+    evmc::VM vm{evmc_create_evmone(), {{"storage_cache", "no"}}};
+    evmc::VM cached_vm{evmc_create_evmone(), {{"storage_cache", "yes"}}};
+    const auto [num_calls, gas_left] = run(vm);
+    const auto [num_cached_calls, cached_gas_left] = run(cached_vm);
+    EXPECT_EQ(cached_gas_left, gas_left);
+
+    // The option changed after the execution states have been created applies on the reuse.
+    ASSERT_EQ(vm.set_option("storage_cache", "yes"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_EQ(run(vm).first, num_cached_calls);
+    ASSERT_EQ(cached_vm.set_option("storage_cache", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_EQ(run(cached_vm).first, num_calls);
+
+    // Without the cache every SLOAD and SSTORE checks the access status and queries the storage.
+    EXPECT_EQ(num_calls, 10 * 4 + 2);
+    // With the cache only the first SLOAD and the one after the call query the host
+    // and the SSTOREs only set the storage.
+    EXPECT_EQ(num_cached_calls, 2 * 2 + 10);
+}
+
+TEST(evmone, set_option_zero_copy_output)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    const auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_FALSE(evmone_vm.zero_copy_output);
+
+    EXPECT_EQ(vm.set_option("zero_copy_output", ""), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_FALSE(evmone_vm.zero_copy_output);
+    EXPECT_EQ(vm.set_option("zero_copy_output", "yes"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_TRUE(evmone_vm.zero_copy_output);
+    EXPECT_EQ(vm.set_option("zero_copy_output", "no"), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_FALSE(evmone_vm.zero_copy_output);
+}
+
+TEST(evmone, zero_copy_output_nested_calls)
+{
+    using namespace evmone::test;
+
+    /// The host executing the nested calls in the VM.
+    class NestedHost : public evmc::MockedHost
+    {
+    public:
+        evmc::VM* vm = nullptr;
+        bytecode callee_code;
+        std::vector<const uint8_t*> outputs;
+
+        evmc::Result call(const evmc_message& msg) noexcept override
+        {
+            auto r = vm->execute(*this, EVMC_CANCUN, msg, callee_code.data(), callee_code.size());
+            outputs.push_back(r.output_data);
+            return r;
+        }
+    };
+
+    // The caller copies the return data of two calls to the consecutive memory words.
+    const auto callee_code = mstore(0, add(calldataload(0), 1)) + ret(0, 32);
+    const auto code = mstore(0, 1) + call(0).gas(0xffff).input(0, 32) + OP_POP +
+                      returndatacopy(32, 0, 32) + mstore(0, 5) +
+                      call(0).gas(0xffff).input(0, 32) + OP_POP + returndatacopy(64, 0, 32) +
+                      ret(32, 64);
+
+    const auto run = [&](const char* zero_copy_output) {
+        evmc::VM vm{evmc_create_evmone(), {{"zero_copy_output", zero_copy_output}}};
+        NestedHost host;
+        host.vm = &vm;
+        host.callee_code = callee_code;
+        evmc_message msg{};
+        msg.gas = 1000000;
+        const auto r = vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+        EXPECT_EQ(r.status_code, EVMC_SUCCESS);
+        EXPECT_EQ(r.output_size, 64);
+        EXPECT_EQ(evmc::bytes_view(r.output_data, 32), evmc::bytes32{2});
+        EXPECT_EQ(evmc::bytes_view(r.output_data + 32, 32), evmc::bytes32{6});
+        return std::pair{host.outputs, r.gas_left};
+    };
+
+    const auto [outputs, gas_left] = run("no");
+    const auto [zero_copy_outputs, zero_copy_gas_left] = run("yes");
+    EXPECT_EQ(zero_copy_gas_left, gas_left);
+
+    // Both outputs are in the memory of the execution state of the depth 1.
+    ASSERT_EQ(zero_copy_outputs.size(), 2);
+    EXPECT_EQ(zero_copy_outputs[0], zero_copy_outputs[1]);
+}
+
+TEST(evmone, concurrent_execution)
+{
+    using namespace evmone::test;
+
+    evmc::VM vm{evmc_create_evmone(),
+        {{"concurrent", "yes"}, {"analysis_cache", "1"}, {"stack_arena", "yes"}}};
+    const auto code = add(calldataload(0), 1) + ret_top();
+
+    constexpr size_t num_threads = 8;
+    std::vector<std::thread> threads;
+    std::array<size_t, num_threads> num_failures{};
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&vm, &code, &failures = num_failures[t], t] {
+            evmc::MockedHost host;
+            for (uint8_t i = 0; i < 200; ++i)
+            {
+                const evmc::bytes32 input{t * 256 + i};
+                evmc_message msg{};
+                msg.gas = 100000;
+                msg.input_data = input.bytes;
+                msg.input_size = sizeof(input);
+                const auto r = vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+                if (r.status_code != EVMC_SUCCESS ||
+                    evmc::bytes_view(r.output_data, r.output_size) !=
+                        evmc::bytes_view(evmc::bytes32{t * 256 + i + 1}))
+                    ++failures;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto failures : num_failures)
+        EXPECT_EQ(failures, 0);
+}
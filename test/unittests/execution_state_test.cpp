@@ -4,7 +4,11 @@
 
 #include <evmone/advanced_analysis.hpp>
 #include <evmone/execution_state.hpp>
+#include <evmone/stack_arena.hpp>
 #include <gtest/gtest.h>
+#include <array>
+#include <cstring>
+#include <memory>
 #include <type_traits>
 
 static_assert(std::is_default_constructible_v<evmone::ExecutionState>);
@@ -80,7 +84,8 @@ TEST(execution_state, reset_advanced)
     st.memory.grow(64);
     st.msg = &msg;
     st.rev = EVMC_BYZANTIUM;
-    st.return_data.push_back('0');
+    const uint8_t output[]{'0'};
+    st.return_data.assign(evmc::Result{EVMC_SUCCESS, 0, 0, output, std::size(output)});
     st.status = EVMC_FAILURE;
     st.output_offset = 3;
     st.output_size = 4;
@@ -144,3 +149,225 @@ TEST(execution_state, memory_view)
     EXPECT_EQ(view[1], 0x00);
     EXPECT_EQ(view[2], 0xc2);
 }
+
+TEST(execution_state, memory_reuse)
+{
+    evmone::Memory memory;
+    EXPECT_FALSE(memory.is_mapped());
+    memory.grow(64);
+    memory[63] = 0xff;
+    memory.clear();
+    memory.grow(96);
+    EXPECT_EQ(memory[63], 0x00);
+}
+
+TEST(execution_state, memory_mapped)
+{
+    evmone::Memory memory;
+    memory.grow(32);
+    memory[0] = 0x01;
+#if EVMONE_MAPPED_MEMORY_SUPPORTED
+    ASSERT_TRUE(memory.reserve_mapping());
+    EXPECT_TRUE(memory.is_mapped());
+    EXPECT_TRUE(memory.reserve_mapping());
+    EXPECT_EQ(memory.size(), 0);
+
+    // Large growth without reallocation.
+    constexpr size_t large_size = 1024 * 1024;
+    const auto* const data = memory.data();
+    memory.grow(large_size);
+    EXPECT_EQ(memory.data(), data);
+    EXPECT_EQ(memory[0], 0x00);
+    EXPECT_EQ(memory[large_size - 1], 0x00);
+    memory[0] = 0xaa;
+    memory[large_size - 1] = 0xbb;
+
+    // The used memory both below and above the clear threshold is zero after the clear.
+    memory.clear();
+    EXPECT_EQ(memory.size(), 0);
+    memory.grow(large_size);
+    EXPECT_EQ(memory.data(), data);
+    EXPECT_EQ(memory[0], 0x00);
+    EXPECT_EQ(memory[large_size - 1], 0x00);
+
+    auto moved = std::move(memory);
+    EXPECT_TRUE(moved.is_mapped());
+    EXPECT_EQ(moved.data(), data);
+
+    // The growth above the reservation moves the memory to the heap.
+    moved[large_size - 1] = 0xcc;
+    constexpr auto huge_size = size_t{evmone::Memory::mapped_capacity} + 32;
+    moved.grow(huge_size);
+    EXPECT_FALSE(moved.is_mapped());
+    EXPECT_EQ(moved.size(), huge_size);
+    EXPECT_EQ(moved[large_size - 1], 0xcc);
+    EXPECT_EQ(moved[huge_size - 1], 0x00);
+
+    // The mapped mode can be entered again and left.
+    ASSERT_TRUE(moved.reserve_mapping());
+    EXPECT_TRUE(moved.is_mapped());
+    EXPECT_EQ(moved.size(), 0);
+    moved.release_mapping();
+    EXPECT_FALSE(moved.is_mapped());
+    EXPECT_EQ(moved.size(), 0);
+    moved.grow(64);
+    EXPECT_EQ(moved[63], 0x00);
+#else
+    memory.release_mapping();
+    EXPECT_EQ(memory[0], 0x01);
+    EXPECT_FALSE(memory.reserve_mapping());
+    EXPECT_FALSE(memory.is_mapped());
+    EXPECT_EQ(memory[0], 0x01);
+#endif
+}
+
+TEST(execution_state, external_stack_space)
+{
+    std::array<evmone::uint256, evmone::StackSpace::limit> items{};
+    evmone::ExecutionState st{items.data()};
+    EXPECT_EQ(st.stack_space.bottom() + 1, items.data());
+
+    // The external stack space is kept by the move.
+    auto moved = std::move(st);
+    EXPECT_EQ(moved.stack_space.bottom() + 1, items.data());
+}
+
+TEST(execution_state, return_stack)
+{
+    const uint8_t code[2]{};
+    evmone::ReturnStack rs;
+    EXPECT_EQ(rs.size(), 0);
+    for (size_t i = 0; i < evmone::ReturnStack::limit; ++i)
+    {
+        EXPECT_FALSE(rs.full());
+        rs.push(&code[i % 2]);
+    }
+    EXPECT_TRUE(rs.full());
+    EXPECT_EQ(rs.pop(), &code[1]);
+    EXPECT_EQ(rs.pop(), &code[0]);
+    EXPECT_EQ(rs.size(), evmone::ReturnStack::limit - 2);
+
+    rs.clear();
+    EXPECT_EQ(rs.size(), 0);
+    rs.push(&code[1]);
+    EXPECT_EQ(rs.pop(), &code[1]);
+}
+
+TEST(execution_state, return_data)
+{
+    static int num_releases = 0;
+    const uint8_t output[]{0xaa, 0xbb};
+    evmc_result result{};
+    result.output_data = output;
+    result.output_size = std::size(output);
+    result.release = [](const evmc_result*) noexcept { ++num_releases; };
+
+    evmone::ReturnData rd;
+    EXPECT_TRUE(rd.empty());
+    rd.assign(evmc::Result{result});
+    EXPECT_EQ(rd.size(), 2);
+    EXPECT_EQ(rd.data(), output);  // The output is not copied.
+    EXPECT_EQ(rd[1], 0xbb);
+    EXPECT_EQ(num_releases, 0);
+
+    rd.assign(evmc::Result{result});
+    EXPECT_EQ(num_releases, 1);
+    rd.clear();
+    EXPECT_EQ(num_releases, 2);
+    EXPECT_TRUE(rd.empty());
+}
+
+TEST(execution_state, frame_arena)
+{
+    constexpr auto alignment = alignof(std::max_align_t);
+    evmone::FrameArena arena;
+    EXPECT_EQ(arena.capacity(), 0);
+
+    auto* const a = arena.allocate(1);
+    auto* const b = arena.allocate(100);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % alignment, 0);
+    EXPECT_EQ(b, a + alignment);
+    const auto capacity = arena.capacity();
+    EXPECT_GE(capacity, 101);
+
+    // The allocation not fitting in the main block gets the overflow block
+    // which is merged into the main block by the reset.
+    EXPECT_NE(arena.allocate(capacity), nullptr);
+    EXPECT_EQ(arena.capacity(), 2 * capacity);
+    arena.reset();
+    EXPECT_EQ(arena.capacity(), 2 * capacity);
+
+    auto* const c = arena.allocate(1);
+    EXPECT_EQ(arena.allocate(capacity), c + alignment);
+    EXPECT_EQ(arena.capacity(), 2 * capacity);
+}
+
+TEST(execution_state, frame_arena_output_lease)
+{
+    const uint8_t data[]{1, 2, 3};
+    evmone::FrameArena arena;
+    auto* const output = arena.allocate_output(std::size(data));
+    std::memcpy(output, data, std::size(data));
+    {
+        const evmc::Result result{arena.lease_output(EVMC_REVERT, 1, 2, output, std::size(data))};
+        EXPECT_TRUE(arena.leased());
+        EXPECT_EQ(result.status_code, EVMC_REVERT);
+        EXPECT_EQ(result.gas_left, 1);
+        EXPECT_EQ(result.gas_refund, 2);
+        EXPECT_EQ(result.output_data, output);
+        EXPECT_EQ(result.output_size, std::size(data));
+
+        // The lease follows the moved arena.
+        evmone::FrameArena moved{std::move(arena)};
+        EXPECT_TRUE(moved.leased());
+        arena = std::move(moved);
+    }
+    EXPECT_FALSE(arena.leased());
+
+    // The released buffer is reused.
+    arena.reset();
+    EXPECT_EQ(arena.allocate_output(std::size(data)), output);
+
+    // The output leased over the reset and the destruction of the arena stays valid.
+    auto arena2 = std::make_unique<evmone::FrameArena>();
+    auto* const output2 = arena2->allocate_output(std::size(data));
+    std::memcpy(output2, data, std::size(data));
+    const evmc::Result result{
+        arena2->lease_output(EVMC_SUCCESS, 0, 0, output2, std::size(data))};
+    arena2->reset();
+    EXPECT_FALSE(arena2->leased());
+    EXPECT_NE(arena2->allocate_output(std::size(data)), output2);
+    arena2.reset();
+    EXPECT_EQ(evmc::bytes_view(result.output_data, result.output_size),
+        evmc::bytes_view(data, std::size(data)));
+}
+
+TEST(execution_state, stack_arena)
+{
+    evmone::StackArena arena;
+    EXPECT_FALSE(arena.reserved());
+#if EVMONE_STACK_ARENA_SUPPORTED
+    ASSERT_TRUE(arena.reserve());
+    EXPECT_TRUE(arena.reserved());
+    EXPECT_TRUE(arena.reserve());
+
+    // The stacks of the consecutive depths are adjacent.
+    EXPECT_EQ(arena.frame(1), arena.frame(0) + evmone::StackSpace::limit);
+    constexpr auto last = evmone::StackArena::num_frames - 1;
+    const auto* const first_frame = reinterpret_cast<const uint8_t*>(arena.frame(0));
+    const auto* const last_frame = reinterpret_cast<const uint8_t*>(arena.frame(last));
+    EXPECT_EQ(static_cast<size_t>(last_frame - first_frame), last * evmone::StackArena::frame_size);
+
+    // The memory is zero-initialized and writable.
+    EXPECT_EQ(arena.frame(0)[0], 0);
+    arena.frame(0)[0] = 1;
+    arena.frame(last)[evmone::StackSpace::limit - 1] = 2;
+    EXPECT_EQ(arena.frame(0)[0], 1);
+    EXPECT_EQ(arena.frame(last)[evmone::StackSpace::limit - 1], 2);
+
+    evmone::ExecutionState st{arena.frame(3)};
+    EXPECT_EQ(st.stack_space.bottom() + 1, arena.frame(3));
+#else
+    EXPECT_FALSE(arena.reserve());
+#endif
+}
@@ -82,3 +82,55 @@ TYPED_TEST(jumpdest_analysis_test, validate)
         }
     }
 }
+
+TEST(jumpdest_analysis, baseline_implementations)
+{
+    // Compare all available baseline jumpdest analysis implementations against the reference.
+    // Apart from the test cases, use pseudo-random codes dense in PUSH and JUMPDEST
+    // instructions crossing the 64-byte blocks of the vectorized implementations.
+    std::vector<bytes> codes;
+    for (const auto& test_case : bytecode_test_cases)
+    {
+        codes.emplace_back(test_case);
+        codes.emplace_back(64 * OP_STOP + test_case);
+        codes.emplace_back(63 * OP_STOP + test_case);
+    }
+    uint32_t seed = 1;
+    for (size_t size = 1; size <= 300; ++size)
+    {
+        bytes code(size, 0);
+        for (auto& b : code)
+        {
+            seed = seed * 1103515245 + 12345;
+            const auto r = static_cast<uint8_t>(seed >> 16);
+            b = (r % 4 == 0) ? uint8_t{OP_JUMPDEST} : r;
+        }
+        codes.emplace_back(std::move(code));
+    }
+
+    for (const auto name : {"scalar", "sse2", "avx2", "neon", "best"})
+    {
+        const auto fn = baseline::get_jumpdest_analysis_fn(name);
+        if (fn == nullptr)
+            continue;
+
+        for (size_t code_idx = 0; code_idx < codes.size(); ++code_idx)
+        {
+            const auto& code = codes[code_idx];
+            const auto expected = reference(code);
+            std::vector<baseline::CodeAnalysis::JumpdestWord> bitset(
+                baseline::CodeAnalysis::jumpdest_bitset_num_words(code.size()), ~uint64_t{0});
+            fn(code, bitset.data());
+
+            constexpr auto word_bits = baseline::CodeAnalysis::JUMPDEST_WORD_BITS;
+            for (size_t i = 0; i < bitset.size() * word_bits; ++i)
+            {
+                const auto bit = ((bitset[i / word_bits] >> (i % word_bits)) & 1) != 0;
+                EXPECT_EQ(bit, expected.check_jumpdest(i))
+                    << name << " code " << code_idx << " [" << i << "]";
+            }
+        }
+    }
+    EXPECT_NE(baseline::get_jumpdest_analysis_fn("best"), nullptr);
+    EXPECT_EQ(baseline::get_jumpdest_analysis_fn("unknown"), nullptr);
+}
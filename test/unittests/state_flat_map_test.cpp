@@ -0,0 +1,182 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <evmc/evmc.hpp>
+#include <gtest/gtest.h>
+#include <test/state/flat_map.hpp>
+#include <algorithm>
+#include <map>
+#include <string>
+
+using namespace evmc::literals;
+using namespace evmone::state;
+
+namespace
+{
+using StorageMap = FlatMap<evmc::bytes32, std::string, StorageKeyHash>;
+
+evmc::bytes32 key(uint64_t n) noexcept
+{
+    return evmc::bytes32{n};
+}
+}  // namespace
+
+TEST(state_flat_map, insert_find_erase)
+{
+    StorageMap m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.find(key(1)), m.end());
+    EXPECT_EQ(m.erase(key(1)), 0);
+
+    const auto [it, inserted] = m.try_emplace(key(1));
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first, key(1));
+    EXPECT_EQ(it->second, "");
+    it->second = "one";
+
+    const auto [it2, inserted2] = m.try_emplace(key(1));
+    EXPECT_FALSE(inserted2);
+    EXPECT_EQ(it2, it);
+    EXPECT_EQ(it2->second, "one");
+
+    EXPECT_FALSE(m.insert({key(1), "uno"}).second);
+    EXPECT_TRUE(m.insert({key(2), "two"}).second);
+    EXPECT_EQ(m.size(), 2);
+    EXPECT_EQ(m[key(1)], "one");
+    EXPECT_EQ(m.find(key(2))->second, "two");
+
+    EXPECT_EQ(m.erase(key(1)), 1);
+    EXPECT_EQ(m.find(key(1)), m.end());
+    EXPECT_EQ(m.size(), 1);
+
+    // The erased entry is reused with the default value.
+    EXPECT_EQ(m[key(3)], "");
+    EXPECT_EQ(m.size(), 2);
+}
+
+TEST(state_flat_map, references_stable)
+{
+    // The Host keeps the references to the values while inserting other entries.
+    StorageMap m;
+    auto& first = m[key(0)];
+    first = "first";
+    for (uint64_t i = 1; i < 10000; ++i)
+        m[key(i)] = std::to_string(i);
+    EXPECT_EQ(&m[key(0)], &first);
+    EXPECT_EQ(first, "first");
+}
+
+TEST(state_flat_map, iteration_order)
+{
+    StorageMap m;
+    for (uint64_t i = 0; i < 100; ++i)
+        m[key(i)] = std::to_string(i);
+    m.erase(key(50));
+
+    uint64_t expected = 0;
+    for (const auto& [k, v] : m)
+    {
+        if (expected == 50)
+            ++expected;
+        EXPECT_EQ(k, key(expected));
+        EXPECT_EQ(v, std::to_string(expected));
+        ++expected;
+    }
+    EXPECT_EQ(expected, 100);
+}
+
+TEST(state_flat_map, compare_with_map)
+{
+    // Mix the insertions and the erasures to exercise the erased buckets and rehashing.
+    StorageMap m;
+    std::map<uint64_t, std::string> expected;
+    uint64_t x = 1;
+    for (int i = 0; i < 100000; ++i)
+    {
+        x = x * 6364136223846793005 + 1442695040888963407;
+        const auto n = (x >> 33) % 3000;
+        if ((x >> 62) == 0)
+        {
+            EXPECT_EQ(m.erase(key(n)), expected.erase(n));
+        }
+        else
+        {
+            m[key(n)] = std::to_string(i);
+            expected[n] = std::to_string(i);
+        }
+    }
+
+    EXPECT_EQ(m.size(), expected.size());
+    for (const auto& [n, v] : expected)
+    {
+        const auto it = m.find(key(n));
+        ASSERT_NE(it, m.end());
+        EXPECT_EQ(it->second, v);
+    }
+    size_t count = 0;
+    for ([[maybe_unused]] const auto& e : m)
+        ++count;
+    EXPECT_EQ(count, expected.size());
+}
+
+TEST(state_flat_map, copy_and_move)
+{
+    FlatMap<evmc::address, int, AddressHash> m;
+    m[0x01_address] = 1;
+    m[0x02_address] = 2;
+
+    auto copy = m;
+    copy[0x01_address] = 10;
+    EXPECT_EQ(m[0x01_address], 1);
+    EXPECT_EQ(copy[0x01_address], 10);
+    EXPECT_EQ(copy[0x02_address], 2);
+
+    const auto moved = std::move(copy);
+    EXPECT_EQ(moved.size(), 2);
+    EXPECT_EQ(moved.find(0x01_address)->second, 10);
+    EXPECT_TRUE(copy.empty());  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(copy.begin(), copy.end());
+}
+
+TEST(state_flat_map, sequential_keys_spread)
+{
+    // The small integer storage keys and the artificial addresses differing in the last bytes
+    // must not collapse into the same buckets.
+    constexpr uint64_t N = 3000;
+    StorageMap slots;
+    FlatMap<evmc::address, int, AddressHash> addresses;
+    for (uint64_t i = 0; i < N; ++i)
+    {
+        slots.try_emplace(key(i));
+        addresses.try_emplace(evmc::address{i});
+        addresses.try_emplace(evmc::address{i << 12});
+    }
+    ASSERT_EQ(slots.size(), N);
+    ASSERT_EQ(addresses.size(), 2 * N - 1);
+
+    size_t slots_total = 0;
+    size_t slots_max = 0;
+    size_t addresses_total = 0;
+    size_t addresses_max = 0;
+    for (uint64_t i = 0; i < N; ++i)
+    {
+        const auto p = slots.probe_length(key(i));
+        slots_total += p;
+        slots_max = std::max(slots_max, p);
+        for (const auto& a : {evmc::address{i}, evmc::address{i << 12}})
+        {
+            const auto q = addresses.probe_length(a);
+            addresses_total += q;
+            addresses_max = std::max(addresses_max, q);
+        }
+    }
+    EXPECT_EQ(slots.probe_length(key(N)), 0);
+
+    // The load factor is at most 3/4, so the linear probing of the well-spread keys
+    // takes about 2.5 buckets on average. The collapsed hashes take hundreds.
+    EXPECT_LT(slots_total, 4 * N);
+    EXPECT_LT(slots_max, 128);
+    EXPECT_LT(addresses_total, 4 * 2 * N);
+    EXPECT_LT(addresses_max, 128);
+}
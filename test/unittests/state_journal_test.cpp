@@ -0,0 +1,178 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <test/state/state.hpp>
+#include <test/state/test_state.hpp>
+#include <vector>
+
+using namespace evmc::literals;
+using namespace evmone::state;
+using namespace evmone::test;
+
+namespace
+{
+constexpr auto A = 0x0a_address;
+constexpr auto B = 0x0b_address;
+
+TestState make_base()
+{
+    TestState base;
+    base[A] = {.nonce = 1, .balance = 10, .storage = {{0x01_bytes32, 0x11_bytes32}}};
+    return base;
+}
+
+/// Records one change of every kind. Returns the checkpoint taken before the changes.
+size_t record_all_kinds(State& state)
+{
+    const auto checkpoint = state.checkpoint();
+
+    auto& a = state.get(A);
+    state.journal_balance_change(A, a.balance);
+    a.balance = 20;
+
+    state.journal_bump_nonce(A);
+    a.nonce += 1;
+
+    auto& s = state.get_storage(A, 0x01_bytes32);
+    state.journal_storage_change(A, 0x01_bytes32, s);
+    s.current = 0x12_bytes32;
+    s.access_status = EVMC_ACCESS_WARM;
+
+    auto& t = a.transient_storage[0x02_bytes32];
+    state.journal_transient_storage_change(A, 0x02_bytes32, t);
+    t = 0x22_bytes32;
+
+    state.journal_access_account(A);
+    a.access_status = EVMC_ACCESS_WARM;
+
+    state.journal_destruct(A);
+    a.destructed = true;
+
+    state.journal_create(B, false);
+    state.insert(B);
+    state.touch(B);
+
+    EXPECT_GT(state.checkpoint(), checkpoint);
+    return checkpoint;
+}
+
+void expect_reverted(State& state)
+{
+    const auto& a = state.get(A);
+    EXPECT_EQ(a.balance, 10);
+    EXPECT_EQ(a.nonce, 1);
+    EXPECT_EQ(state.get_storage(A, 0x01_bytes32).current, 0x11_bytes32);
+    EXPECT_EQ(state.get_storage(A, 0x01_bytes32).access_status, EVMC_ACCESS_COLD);
+    EXPECT_EQ(a.transient_storage.find(0x02_bytes32)->second, bytes32{});
+    EXPECT_EQ(a.access_status, EVMC_ACCESS_COLD);
+    EXPECT_FALSE(a.destructed);
+    EXPECT_EQ(state.find(B), nullptr);
+}
+}  // namespace
+
+TEST(state_journal, rollback_each_kind)
+{
+    const auto base = make_base();
+    State state{base};
+    EXPECT_EQ(state.checkpoint(), 0);
+
+    const auto checkpoint = record_all_kinds(state);
+    const auto& a = state.get(A);
+    EXPECT_EQ(a.balance, 20);
+    EXPECT_EQ(a.nonce, 2);
+    EXPECT_TRUE(a.destructed);
+    EXPECT_TRUE(state.get(B).erase_if_empty);
+
+    state.rollback(checkpoint);
+    EXPECT_EQ(state.checkpoint(), checkpoint);
+    expect_reverted(state);
+}
+
+TEST(state_journal, rollback_then_replay)
+{
+    const auto base = make_base();
+    State state{base};
+
+    const auto checkpoint = record_all_kinds(state);
+    const auto size = state.checkpoint();
+    state.rollback(checkpoint);
+    expect_reverted(state);
+
+    // Recording the same changes again reuses the journal and is reverted the same way.
+    EXPECT_EQ(record_all_kinds(state), checkpoint);
+    EXPECT_EQ(state.checkpoint(), size);
+    EXPECT_EQ(state.get(A).balance, 20);
+    state.rollback(checkpoint);
+    expect_reverted(state);
+}
+
+TEST(state_journal, nested_checkpoints)
+{
+    const auto base = make_base();
+    State state{base};
+
+    auto& a = state.get(A);
+    state.journal_balance_change(A, a.balance);
+    a.balance = 11;
+    const auto outer = state.checkpoint();
+
+    state.journal_balance_change(A, a.balance);
+    a.balance = 12;
+    const auto inner = state.checkpoint();
+
+    state.journal_bump_nonce(A);
+    a.nonce += 1;
+
+    state.rollback(inner);
+    EXPECT_EQ(a.nonce, 1);
+    EXPECT_EQ(a.balance, 12);
+
+    state.rollback(outer);
+    EXPECT_EQ(a.balance, 11);
+
+    state.rollback(0);
+    EXPECT_EQ(a.balance, 10);
+    EXPECT_EQ(state.checkpoint(), 0);
+}
+
+TEST(state_journal, rollback_across_growth)
+{
+    const auto base = make_base();
+    State state{base};
+
+    // Record enough entries of mixed sizes to reallocate the journal buffer many times.
+    constexpr uint64_t N = 1000;
+    auto& a = state.get(A);
+    std::vector<size_t> checkpoints;
+    for (uint64_t i = 1; i <= N; ++i)
+    {
+        checkpoints.push_back(state.checkpoint());
+        const auto key = bytes32{i};
+        auto& s = state.get_storage(A, key);
+        state.journal_storage_change(A, key, s);
+        s.current = bytes32{i + N};
+
+        state.journal_balance_change(A, a.balance);
+        a.balance += 1;
+
+        state.journal_bump_nonce(A);
+        a.nonce += 1;
+    }
+    EXPECT_EQ(a.nonce, 1 + N);
+
+    // Revert the second half and check the first half is intact.
+    state.rollback(checkpoints[N / 2]);
+    EXPECT_EQ(a.balance, 10 + N / 2);
+    EXPECT_EQ(a.nonce, 1 + N / 2);
+    EXPECT_EQ(state.get_storage(A, bytes32{N / 2}).current, bytes32{N / 2 + N});
+    EXPECT_EQ(state.get_storage(A, bytes32{N / 2 + 1}).current, bytes32{});
+
+    state.rollback(checkpoints[0]);
+    EXPECT_EQ(a.balance, 10);
+    EXPECT_EQ(a.nonce, 1);
+    EXPECT_EQ(state.get_storage(A, 0x01_bytes32).current, 0x11_bytes32);
+    EXPECT_EQ(state.get_storage(A, bytes32{N}).current, bytes32{});
+    EXPECT_EQ(state.checkpoint(), 0);
+}
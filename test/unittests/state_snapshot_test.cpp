@@ -0,0 +1,108 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <test/state/state.hpp>
+#include <test/state/state_snapshot.hpp>
+#include <test/state/test_state.hpp>
+#include <test/utils/utils.hpp>
+#include <filesystem>
+#include <fstream>
+
+using namespace intx::literals;
+using namespace evmone;
+using namespace evmone::state;
+using namespace evmone::test;
+
+namespace
+{
+/// Returns the unique path of the snapshot file in the temporary directory.
+std::string temp_snapshot_path()
+{
+    const auto* const test_info = testing::UnitTest::GetInstance()->current_test_info();
+    const auto path = std::filesystem::temp_directory_path() /
+                      (std::string{"evmone_"} + test_info->name() + ".snapshot");
+    std::filesystem::remove(path);
+    return path.string();
+}
+}  // namespace
+
+TEST(state_snapshot, write_and_open)
+{
+#if defined(_WIN32)
+    GTEST_SKIP() << "the state snapshot is not supported";
+#endif
+    TestState state;
+    state[0x01_address] = {.nonce = 1, .balance = 0x0102030405060708090a0b0c0d0e0f10_u256};
+    state[0x02_address] = {
+        .storage = {{0x01_bytes32, 0x11_bytes32}, {0x03_bytes32, 0x13_bytes32}},
+        .code = bytes{0x60, 0x00},
+    };
+    state[0x03_address] = {.nonce = 3, .code = bytes{0x60, 0x00}};
+    state[0x04_address] = {.code = bytes{0x00}};
+
+    const auto path = temp_snapshot_path();
+    ASSERT_TRUE(StateSnapshot::write(path, state));
+    const auto snapshot = StateSnapshot::open(path);
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->num_accounts(), 4);
+    EXPECT_EQ(snapshot->num_codes(), 2);  // The code of 0x02 and 0x03 is deduplicated.
+
+    for (const auto& [addr, acc] : state)
+    {
+        const auto expected = state.get_account(addr);
+        const auto actual = snapshot->get_account(addr);
+        ASSERT_TRUE(actual.has_value());
+        EXPECT_EQ(actual->nonce, expected->nonce);
+        EXPECT_EQ(actual->balance, expected->balance);
+        EXPECT_EQ(actual->code_hash, expected->code_hash);
+        EXPECT_EQ(actual->has_storage, expected->has_storage);
+        EXPECT_EQ(snapshot->get_account_code(addr), acc.code);
+    }
+
+    EXPECT_FALSE(snapshot->get_account(0x05_address).has_value());
+    EXPECT_TRUE(snapshot->get_account_code(0x05_address).empty());
+    EXPECT_EQ(snapshot->get_storage(0x02_address, 0x01_bytes32), 0x11_bytes32);
+    EXPECT_EQ(snapshot->get_storage(0x02_address, 0x02_bytes32), bytes32{});
+    EXPECT_EQ(snapshot->get_storage(0x02_address, 0x03_bytes32), 0x13_bytes32);
+    EXPECT_EQ(snapshot->get_storage(0x01_address, 0x01_bytes32), bytes32{});
+    EXPECT_EQ(snapshot->get_storage(0x05_address, 0x01_bytes32), bytes32{});
+    EXPECT_EQ(snapshot->get_account(0x01_address)->code_hash, Account::EMPTY_CODE_HASH);
+
+    std::filesystem::remove(path);
+}
+
+TEST(state_snapshot, empty_state)
+{
+#if defined(_WIN32)
+    GTEST_SKIP() << "the state snapshot is not supported";
+#endif
+    const auto path = temp_snapshot_path();
+    ASSERT_TRUE(StateSnapshot::write(path, TestState{}));
+    const auto snapshot = StateSnapshot::open(path);
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->num_accounts(), 0);
+    EXPECT_FALSE(snapshot->get_account(0x01_address).has_value());
+    std::filesystem::remove(path);
+}
+
+TEST(state_snapshot, invalid_file)
+{
+    const auto path = temp_snapshot_path();
+    EXPECT_EQ(StateSnapshot::open(path), nullptr);  // Missing file.
+
+    {
+        std::ofstream f{path, std::ios::binary};
+        f << "not a snapshot file, but long enough for the header";
+    }
+    EXPECT_EQ(StateSnapshot::open(path), nullptr);
+
+    // The truncated snapshot.
+    TestState state;
+    state[0x01_address] = {.nonce = 1};
+    ASSERT_TRUE(StateSnapshot::write(path, state));
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_EQ(StateSnapshot::open(path), nullptr);
+    std::filesystem::remove(path);
+}
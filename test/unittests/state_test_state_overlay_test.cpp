@@ -0,0 +1,131 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2025 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <test/state/mpt_hash.hpp>
+#include <test/state/state.hpp>
+#include <test/state/test_state.hpp>
+#include <test/utils/utils.hpp>
+
+using namespace evmone;
+using namespace evmone::state;
+using namespace evmone::test;
+
+namespace
+{
+TestState make_base()
+{
+    TestState base;
+    base[0x01_address] = {.nonce = 1, .balance = 10, .storage = {{0x01_bytes32, 0x11_bytes32}}};
+    base[0x02_address] = {.nonce = 2,
+        .storage = {{0x01_bytes32, 0x21_bytes32}, {0x02_bytes32, 0x22_bytes32}},
+        .code = bytes{0x60, 0x00}};
+    base[0x03_address] = {.balance = 30};
+    return base;
+}
+
+/// Returns the base state with the changes of the overlay applied.
+TestState materialize(const TestState& base, const TestStateOverlay& overlay)
+{
+    auto state = base;
+    state.apply(overlay.diff());
+    return state;
+}
+}  // namespace
+
+TEST(state_test_state_overlay, reads_base)
+{
+    const auto base = make_base();
+    const TestStateOverlay overlay{base};
+
+    EXPECT_EQ(overlay.get_account(0x01_address)->nonce, 1);
+    EXPECT_TRUE(overlay.get_account(0x01_address)->has_storage);
+    EXPECT_FALSE(overlay.get_account(0x04_address).has_value());
+    EXPECT_EQ(overlay.get_account_code(0x02_address), (bytes{0x60, 0x00}));
+    EXPECT_EQ(overlay.get_storage(0x02_address, 0x02_bytes32), 0x22_bytes32);
+    EXPECT_EQ(mpt_hash(overlay), mpt_hash(base));
+}
+
+TEST(state_test_state_overlay, apply_does_not_modify_base)
+{
+    const auto base = make_base();
+    TestStateOverlay overlay{base};
+
+    StateDiff diff;
+    diff.modified_accounts.push_back({.addr = 0x02_address,
+        .nonce = 3,
+        .balance = 7,
+        .code = std::nullopt,
+        .modified_storage = {{0x01_bytes32, {}}, {0x03_bytes32, 0x23_bytes32}}});
+    diff.modified_accounts.push_back({.addr = 0x04_address, .nonce = 1, .balance = 40});
+    diff.deleted_accounts.push_back(0x03_address);
+    overlay.apply(diff);
+
+    EXPECT_EQ(overlay.get_account(0x02_address)->nonce, 3);
+    EXPECT_EQ(overlay.get_account(0x02_address)->code_hash, keccak256(bytes{0x60, 0x00}));
+    EXPECT_EQ(overlay.get_storage(0x02_address, 0x01_bytes32), bytes32{});
+    EXPECT_EQ(overlay.get_storage(0x02_address, 0x02_bytes32), 0x22_bytes32);
+    EXPECT_EQ(overlay.get_storage(0x02_address, 0x03_bytes32), 0x23_bytes32);
+    EXPECT_EQ(overlay.get_account(0x04_address)->balance, 40);
+    EXPECT_EQ(overlay.get_account(0x04_address)->code_hash, Account::EMPTY_CODE_HASH);
+    EXPECT_FALSE(overlay.get_account(0x03_address).has_value());
+
+    // The base state is not modified.
+    EXPECT_TRUE(base == make_base());
+
+    const auto expected = materialize(base, overlay);
+    EXPECT_EQ(expected.at(0x02_address).storage.size(), 2);
+    EXPECT_FALSE(expected.contains(0x03_address));
+    EXPECT_EQ(mpt_hash(overlay), mpt_hash(expected));
+}
+
+TEST(state_test_state_overlay, recreated_account)
+{
+    const auto base = make_base();
+    TestStateOverlay overlay{base};
+
+    StateDiff destruct;
+    destruct.deleted_accounts.push_back(0x02_address);
+    overlay.apply(destruct);
+
+    StateDiff create;
+    create.modified_accounts.push_back({.addr = 0x02_address,
+        .nonce = 1,
+        .balance = 0,
+        .code = std::nullopt,
+        .modified_storage = {{0x02_bytes32, 0x32_bytes32}}});
+    overlay.apply(create);
+
+    // The storage and the code of the base account are not visible.
+    EXPECT_EQ(overlay.get_storage(0x02_address, 0x01_bytes32), bytes32{});
+    EXPECT_EQ(overlay.get_storage(0x02_address, 0x02_bytes32), 0x32_bytes32);
+    EXPECT_TRUE(overlay.get_account_code(0x02_address).empty());
+    EXPECT_EQ(overlay.get_account(0x02_address)->code_hash, Account::EMPTY_CODE_HASH);
+
+    const auto expected = materialize(base, overlay);
+    const auto& acc = expected.at(0x02_address);
+    EXPECT_TRUE(acc.code.empty());
+    EXPECT_EQ(acc.storage, (std::map<bytes32, bytes32>{{0x02_bytes32, 0x32_bytes32}}));
+    EXPECT_EQ(mpt_hash(overlay), mpt_hash(expected));
+}
+
+TEST(state_test_state_overlay, has_storage)
+{
+    const auto base = make_base();
+    TestStateOverlay overlay{base};
+
+    // Delete the only storage entry of the account.
+    StateDiff diff;
+    diff.modified_accounts.push_back({.addr = 0x01_address,
+        .nonce = 1,
+        .balance = 10,
+        .code = std::nullopt,
+        .modified_storage = {{0x01_bytes32, {}}}});
+    overlay.apply(diff);
+    EXPECT_FALSE(overlay.get_account(0x01_address)->has_storage);
+
+    diff.modified_accounts[0].modified_storage = {{0x05_bytes32, 0x15_bytes32}};
+    overlay.apply(diff);
+    EXPECT_TRUE(overlay.get_account(0x01_address)->has_storage);
+}